@@ -0,0 +1,87 @@
+// SPDX-FileCopyrightText: Deutsches Elektronen-Synchrotron DESY, MSK, ChimeraTK Project <chimeratk-support@desy.de>
+// SPDX-License-Identifier: LGPL-3.0-or-later
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <iomanip>
+#include <map>
+#include <ostream>
+#include <string>
+#include <vector>
+
+/**
+ * Collects benchmark results and writes them as JSON, so results can be compared between releases. Each result
+ * consists of the number of iterations, the total wall time and (optionally) the latencies of the individual
+ * iterations, from which the percentiles are computed.
+ */
+class BenchmarkReport {
+ public:
+  struct Result {
+    std::string name;
+    size_t iterations{0};
+    double totalSeconds{0};
+    std::vector<double> latenciesUs;
+    std::map<std::string, double> extra;
+  };
+
+  /// Run f() the given number of times and record the latency of each call
+  template<typename F>
+  Result& measure(const std::string& name, size_t iterations, F f) {
+    Result r;
+    r.name = name;
+    r.iterations = iterations;
+    r.latenciesUs.reserve(iterations);
+    auto begin = std::chrono::steady_clock::now();
+    for(size_t i = 0; i < iterations; ++i) {
+      auto t0 = std::chrono::steady_clock::now();
+      f();
+      auto t1 = std::chrono::steady_clock::now();
+      r.latenciesUs.push_back(std::chrono::duration<double, std::micro>(t1 - t0).count());
+    }
+    r.totalSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+    return add(std::move(r));
+  }
+
+  /// Add a result which has been measured externally
+  Result& add(Result r) {
+    _results.push_back(std::move(r));
+    return _results.back();
+  }
+
+  void write(std::ostream& os, const std::map<std::string, std::string>& context) const {
+    os << std::setprecision(6) << std::fixed;
+    os << "{\n  \"context\": {";
+    bool first = true;
+    for(const auto& [key, value] : context) {
+      os << (first ? "" : ",") << "\n    \"" << key << "\": \"" << value << "\"";
+      first = false;
+    }
+    os << "\n  },\n  \"benchmarks\": [";
+    first = true;
+    for(const auto& r : _results) {
+      os << (first ? "" : ",") << "\n    {\"name\": \"" << r.name << "\", \"iterations\": " << r.iterations
+         << ", \"total_s\": " << r.totalSeconds
+         << ", \"ops_per_s\": " << (r.totalSeconds > 0 ? double(r.iterations) / r.totalSeconds : 0.);
+      if(!r.latenciesUs.empty()) {
+        auto sorted = r.latenciesUs;
+        std::sort(sorted.begin(), sorted.end());
+        auto at = [&](double fraction) { return sorted[size_t(fraction * double(sorted.size() - 1))]; };
+        double sum = 0;
+        for(auto v : sorted) sum += v;
+        os << ", \"mean_us\": " << sum / double(sorted.size()) << ", \"p50_us\": " << at(0.5)
+           << ", \"p90_us\": " << at(0.9) << ", \"p99_us\": " << at(0.99) << ", \"max_us\": " << sorted.back();
+      }
+      for(const auto& [key, value] : r.extra) {
+        os << ", \"" << key << "\": " << value;
+      }
+      os << "}";
+      first = false;
+    }
+    os << "\n  ]\n}\n";
+  }
+
+ private:
+  std::vector<Result> _results;
+};
@@ -0,0 +1,275 @@
+// SPDX-FileCopyrightText: Deutsches Elektronen-Synchrotron DESY, MSK, ChimeraTK Project <chimeratk-support@desy.de>
+// SPDX-License-Identifier: LGPL-3.0-or-later
+
+/*
+ * Benchmarks of the DoocsBackend against the dummy DOOCS server used by the tests.
+ *
+ * Usage: benchmarkDoocsBackend [--json=<output file>] [--iterations=<n>]
+ *
+ * The results are written as JSON to the given file (or to stdout if no file is given). The number of iterations
+ * scales all RPC measurements, the default is 1000.
+ */
+
+#include "BenchmarkReport.h"
+#include "DoocsBackendRegisterAccessor.h"
+#include "eq_dummy.h"
+
+#include <ChimeraTK/Device.h>
+#include <ChimeraTK/DeviceAccessVersion.h>
+
+#include <doocs-server-test-helper/doocsServerTestHelper.h>
+#include <doocs-server-test-helper/ThreadedDoocsServer.h>
+#include <doocs/EqCall.h>
+
+#include <unistd.h>
+
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+using namespace ChimeraTK;
+
+/**********************************************************************************************************************/
+
+static void benchmarkRpc(BenchmarkReport& report, const std::string& cdd, size_t iterations) {
+  Device device;
+  device.open(cdd);
+
+  auto scalar = device.getScalarRegisterAccessor<int32_t>("MYDUMMY/SOME_INT");
+  report.measure("rpc_scalar_read", iterations, [&] { scalar.read(); });
+  report.measure("rpc_scalar_write", iterations, [&] { scalar.write(); });
+
+  auto array = device.getOneDRegisterAccessor<int32_t>("MYDUMMY/SOME_INT_ARRAY");
+  report.measure("rpc_array_read", iterations, [&] { array.read(); }).extra["elements"] = array.getNElements();
+  report.measure("rpc_array_write", iterations, [&] { array.write(); }).extra["elements"] = array.getNElements();
+
+  auto partial = device.getOneDRegisterAccessor<int32_t>("MYDUMMY/SOME_INT_ARRAY", 10, 5);
+  report.measure("rpc_partial_array_write", iterations, [&] { partial.write(); }).extra["elements"] =
+      partial.getNElements();
+
+  auto spectrum = device.getOneDRegisterAccessor<float>("MYDUMMY/SOME_SPECTRUM");
+  report.measure("rpc_spectrum_read", iterations, [&] { spectrum.read(); }).extra["elements"] =
+      spectrum.getNElements();
+}
+
+/**********************************************************************************************************************/
+
+static void benchmarkAccessorCreation(BenchmarkReport& report, const std::string& cdd, size_t iterations) {
+  Device device;
+  device.open(cdd);
+  report.measure("accessor_creation_rpc", iterations,
+      [&] { auto acc = device.getScalarRegisterAccessor<int32_t>("MYDUMMY/SOME_INT"); });
+  report.measure("accessor_creation_zmq", iterations, [&] {
+    auto acc = device.getScalarRegisterAccessor<int32_t>("MYDUMMY/SOME_ZMQINT", 0, {AccessMode::wait_for_new_data});
+  });
+}
+
+/**********************************************************************************************************************/
+
+/// Resident set size of the process in bytes
+static size_t residentBytes() {
+  std::ifstream statm("/proc/self/statm");
+  size_t total = 0, resident = 0;
+  statm >> total >> resident;
+  return resident * size_t(sysconf(_SC_PAGESIZE));
+}
+
+/**********************************************************************************************************************/
+
+static void benchmarkAccessorMemory(BenchmarkReport& report, const std::string& cdd, size_t nAccessors) {
+  Device device;
+  device.open(cdd);
+  device.activateAsyncRead();
+
+  // Resident memory per accessor, right after creation and after a transfer (buffers are allocated on demand). The
+  // accessors are created outside of report.measure(), so the recorded latencies do not count as accessor memory.
+  auto measureFootprint = [&](const std::string& name, auto create, auto transfer) {
+    using Accessor = decltype(create());
+    std::vector<Accessor> accessors;
+    accessors.reserve(nAccessors);
+    BenchmarkReport::Result result;
+    result.name = name;
+    result.iterations = nAccessors;
+    auto before = residentBytes();
+    auto begin = std::chrono::steady_clock::now();
+    for(size_t i = 0; i < nAccessors; ++i) {
+      accessors.emplace_back(create());
+    }
+    result.totalSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+    auto created = residentBytes();
+    transfer(accessors);
+    auto transferred = residentBytes();
+    result.extra["bytes_per_accessor"] = (double(created) - double(before)) / double(nAccessors);
+    result.extra["bytes_per_accessor_after_transfer"] = (double(transferred) - double(before)) / double(nAccessors);
+    report.add(std::move(result));
+  };
+
+  auto readAll = [](auto& accessors) {
+    for(auto& acc : accessors) acc.read();
+  };
+  auto writeAll = [](auto& accessors) {
+    for(auto& acc : accessors) acc.write();
+  };
+
+  measureFootprint(
+      "accessor_memory_rpc_scalar", [&] { return device.getScalarRegisterAccessor<int32_t>("MYDUMMY/SOME_INT"); },
+      readAll);
+  measureFootprint(
+      "accessor_memory_rpc_array", [&] { return device.getOneDRegisterAccessor<int32_t>("MYDUMMY/SOME_INT_ARRAY"); },
+      [&](auto& accessors) {
+        readAll(accessors);
+        writeAll(accessors);
+      });
+  measureFootprint(
+      "accessor_memory_rpc_partial_array",
+      [&] { return device.getOneDRegisterAccessor<int32_t>("MYDUMMY/SOME_INT_ARRAY", 10, 5); },
+      [&](auto& accessors) {
+        readAll(accessors);
+        writeAll(accessors);
+      });
+  measureFootprint(
+      "accessor_memory_zmq_scalar",
+      [&] {
+        return device.getScalarRegisterAccessor<int32_t>("MYDUMMY/SOME_ZMQINT", 0, {AccessMode::wait_for_new_data});
+      },
+      [&](auto& accessors) {
+        // fill the notification queues of all accessors, so the pool has allocated its buffers
+        for(size_t i = 0; i < 10; ++i) DoocsServerTestHelper::runUpdate();
+        usleep(100000);
+        for(auto& acc : accessors) acc.readLatest();
+      });
+
+  // size of the accessor objects themselves, without the data allocated on the heap
+  BenchmarkReport::Result sizes;
+  sizes.name = "accessor_object_size";
+  sizes.extra["accessor_base_bytes"] = double(sizeof(DoocsBackendRegisterAccessorBase));
+  sizes.extra["eq_data_bytes"] = double(sizeof(doocs::EqData));
+  sizes.extra["rpc_context_bytes"] = double(sizeof(DoocsBackendRegisterAccessorBase::RpcContext));
+  report.add(std::move(sizes));
+}
+
+/**********************************************************************************************************************/
+
+static void benchmarkZmqFanOut(BenchmarkReport& report, const std::string& cdd, size_t nListeners, size_t nUpdates) {
+  Device device;
+  device.open(cdd);
+  device.activateAsyncRead();
+
+  std::vector<ScalarRegisterAccessor<int32_t>> accessors;
+  for(size_t i = 0; i < nListeners; ++i) {
+    accessors.push_back(
+        device.getScalarRegisterAccessor<int32_t>("MYDUMMY/SOME_ZMQINT", 0, {AccessMode::wait_for_new_data}));
+  }
+
+  // wait until the subscription delivers updates reliably, then empty the queues
+  size_t ic = 0;
+  while(!accessors.front().readNonBlocking() || ++ic < 10) {
+    DoocsServerTestHelper::runUpdate();
+  }
+  usleep(100000);
+  for(auto& acc : accessors) acc.readLatest();
+
+  // Each update is read by all listeners. The queues hold only a few elements, so read after each update.
+  BenchmarkReport::Result result;
+  result.name = "zmq_fan_out";
+  result.iterations = nUpdates * nListeners;
+  auto begin = std::chrono::steady_clock::now();
+  for(size_t i = 0; i < nUpdates; ++i) {
+    auto t0 = std::chrono::steady_clock::now();
+    DoocsServerTestHelper::runUpdate();
+    for(auto& acc : accessors) acc.read();
+    auto t1 = std::chrono::steady_clock::now();
+    result.latenciesUs.push_back(std::chrono::duration<double, std::micro>(t1 - t0).count());
+  }
+  result.totalSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+  result.extra["listeners"] = double(nListeners);
+  report.add(std::move(result));
+}
+
+/**********************************************************************************************************************/
+
+static void benchmarkCatalogue(BenchmarkReport& report, const std::string& serverAddress, size_t iterations) {
+  std::string cacheFile = "benchmarkDoocsBackend_cache.xml";
+  std::remove(cacheFile.c_str());
+
+  // fetch time: each iteration uses a new backend instance, so the catalogue is fetched from the server
+  report.measure("catalogue_fetch", iterations, [&] {
+    Device device("(doocs:" + serverAddress + ")");
+    auto catalogue = device.getRegisterCatalogue();
+  });
+
+  // create the cache file
+  {
+    Device device("(doocs:" + serverAddress + "?cacheFile=" + cacheFile + ")");
+    auto catalogue = device.getRegisterCatalogue();
+  }
+
+  auto& result = report.measure("catalogue_cache_load", iterations, [&] {
+    Device device("(doocs:" + serverAddress + "?cacheFile=" + cacheFile + ")");
+    auto catalogue = device.getRegisterCatalogue();
+  });
+  Device device("(doocs:" + serverAddress + "?cacheFile=" + cacheFile + ")");
+  result.extra["registers"] = double(device.getRegisterCatalogue().getNumberOfRegisters());
+
+  std::remove(cacheFile.c_str());
+}
+
+/**********************************************************************************************************************/
+
+int main(int argc, char* argv[]) {
+  // extract our own arguments, pass the remaining ones to the DOOCS server
+  std::string jsonFile;
+  size_t iterations = 1000;
+  std::vector<char*> serverArgs;
+  for(int i = 0; i < argc; ++i) {
+    std::string arg = argv[i];
+    if(arg.rfind("--json=", 0) == 0) {
+      jsonFile = arg.substr(7);
+    }
+    else if(arg.rfind("--iterations=", 0) == 0) {
+      iterations = std::stoul(arg.substr(13));
+    }
+    else {
+      serverArgs.push_back(argv[i]);
+    }
+  }
+
+  int serverArgc = int(serverArgs.size());
+  serverArgs.push_back(nullptr);
+  ThreadedDoocsServer server("benchmarkDoocsBackend.conf", serverArgc, serverArgs.data(), eq_dummy::createServer());
+
+  // wait until server has started (both the update thread and the rpc thread)
+  std::string serverAddress = "doocs://localhost:" + server.rpcNo() + "/F/D";
+  doocs::EqCall eq;
+  doocs::EqAdr ea;
+  doocs::EqData src, dst;
+  ea.adr(serverAddress + "/MYDUMMY/SOME_ZMQINT");
+  while(eq.get(&ea, &src, &dst)) usleep(100000);
+
+  std::string cdd = "(doocs:" + serverAddress + ")";
+
+  BenchmarkReport report;
+  benchmarkRpc(report, cdd, iterations);
+  benchmarkAccessorCreation(report, cdd, iterations / 10 + 1);
+  benchmarkAccessorMemory(report, cdd, iterations * 10);
+  for(size_t nListeners : {1, 10, 100}) {
+    benchmarkZmqFanOut(report, cdd, nListeners, iterations / 10 + 1);
+  }
+  benchmarkCatalogue(report, serverAddress, iterations / 100 + 1);
+
+  std::map<std::string, std::string> context{
+      {"executable", "benchmarkDoocsBackend"}, {"deviceaccess_version", CHIMERATK_DEVICEACCESS_VERSION}};
+  if(jsonFile.empty()) {
+    report.write(std::cout, context);
+  }
+  else {
+    std::ofstream f(jsonFile);
+    report.write(f, context);
+    std::cout << "Benchmark results written to " << jsonFile << std::endl;
+  }
+
+  return 0;
+}
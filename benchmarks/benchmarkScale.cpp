@@ -0,0 +1,156 @@
+// SPDX-FileCopyrightText: Deutsches Elektronen-Synchrotron DESY, MSK, ChimeraTK Project <chimeratk-support@desy.de>
+// SPDX-License-Identifier: LGPL-3.0-or-later
+
+/*
+ * Scale benchmarks of the DoocsBackend against the synthetic DOOCS server (eq_synthetic). The number and types of
+ * properties as well as the ZeroMQ publish rate are configured in benchmarkScale.conf (copied from
+ * tests/doocsSynthetic_rpc_server.conf).
+ *
+ * Usage: benchmarkScale [--json=<output file>] [--seconds=<duration of the ZeroMQ measurement>]
+ */
+
+#include "BenchmarkReport.h"
+#include "eq_synthetic.h"
+
+#include <ChimeraTK/Device.h>
+#include <ChimeraTK/DeviceAccessVersion.h>
+
+#include <doocs-server-test-helper/ThreadedDoocsServer.h>
+#include <doocs/EqCall.h>
+
+#include <unistd.h>
+
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+using namespace ChimeraTK;
+
+/**********************************************************************************************************************/
+
+static void benchmarkCatalogue(BenchmarkReport& report, const std::string& serverAddress) {
+  std::string cacheFile = "benchmarkScale_cache.xml";
+  std::remove(cacheFile.c_str());
+
+  size_t nRegisters = 0;
+  auto& fetch = report.measure("scale_catalogue_fetch", 1, [&] {
+    Device device("(doocs:" + serverAddress + "?cacheFile=" + cacheFile + ")");
+    nRegisters = device.getRegisterCatalogue().getNumberOfRegisters();
+  });
+  fetch.extra["registers"] = double(nRegisters);
+
+  auto& load = report.measure("scale_catalogue_cache_load", 3, [&] {
+    Device device("(doocs:" + serverAddress + "?cacheFile=" + cacheFile + ")");
+    auto catalogue = device.getRegisterCatalogue();
+  });
+  load.extra["registers"] = double(nRegisters);
+
+  Device device("(doocs:" + serverAddress + "?cacheFile=" + cacheFile + ")");
+  report.measure("scale_catalogue_handout", 1000, [&] { auto catalogue = device.getRegisterCatalogue(); });
+
+  std::remove(cacheFile.c_str());
+}
+
+/**********************************************************************************************************************/
+
+static void benchmarkSubscriptions(
+    BenchmarkReport& report, const std::string& serverAddress, eq_synthetic& location, double seconds) {
+  Device device;
+  device.open("(doocs:" + serverAddress + ")");
+
+  // subscribe to all published properties
+  auto names = location.getPropertyNames();
+  names.resize(std::min(names.size(), size_t(location.prop_nZmqProperties.value())));
+  std::vector<TransferElementAbstractor> accessors;
+  auto& subscribe = report.measure("scale_subscribe", 1, [&] {
+    for(const auto& name : names) {
+      // all types can be read as string
+      accessors.emplace_back(device.getOneDRegisterAccessor<std::string>(
+          location.name_str() + "/" + name, 0, 0, {AccessMode::wait_for_new_data}));
+    }
+    device.activateAsyncRead();
+  });
+  subscribe.extra["subscriptions"] = double(accessors.size());
+
+  // receive for the given time, counting the received updates
+  BenchmarkReport::Result result;
+  result.name = "scale_zmq_receive";
+  auto begin = std::chrono::steady_clock::now();
+  auto end = begin + std::chrono::duration<double>(seconds);
+  size_t nUpdates = 0;
+  while(std::chrono::steady_clock::now() < end) {
+    bool any = false;
+    for(auto& acc : accessors) {
+      while(acc.readNonBlocking()) {
+        ++nUpdates;
+        any = true;
+      }
+    }
+    if(!any) usleep(100);
+  }
+  result.iterations = nUpdates;
+  result.totalSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+  result.extra["subscriptions"] = double(accessors.size());
+  result.extra["expected_updates_per_s"] = double(accessors.size()) * location.prop_zmqRate.value();
+  report.add(std::move(result));
+}
+
+/**********************************************************************************************************************/
+
+int main(int argc, char* argv[]) {
+  std::string jsonFile;
+  double seconds = 10;
+  std::vector<char*> serverArgs;
+  for(int i = 0; i < argc; ++i) {
+    std::string arg = argv[i];
+    if(arg.rfind("--json=", 0) == 0) {
+      jsonFile = arg.substr(7);
+    }
+    else if(arg.rfind("--seconds=", 0) == 0) {
+      seconds = std::stod(arg.substr(10));
+    }
+    else {
+      serverArgs.push_back(argv[i]);
+    }
+  }
+
+  int serverArgc = int(serverArgs.size());
+  serverArgs.push_back(nullptr);
+  ThreadedDoocsServer server("benchmarkScale.conf", serverArgc, serverArgs.data(), eq_synthetic::createServer());
+
+  // wait until server has started
+  std::string serverAddress = "doocs://localhost:" + server.rpcNo() + "/F/D";
+  doocs::EqCall eq;
+  doocs::EqAdr ea;
+  doocs::EqData src, dst;
+  ea.adr(serverAddress + "/SYNTHETIC/N_PROPERTIES");
+  while(eq.get(&ea, &src, &dst)) usleep(100000);
+
+  auto location = dynamic_cast<eq_synthetic*>(find_device("SYNTHETIC"));
+  if(!location) {
+    std::cerr << "Location SYNTHETIC not found, check benchmarkScale.conf" << std::endl;
+    return 1;
+  }
+
+  BenchmarkReport report;
+  benchmarkCatalogue(report, serverAddress);
+  benchmarkSubscriptions(report, serverAddress, *location, seconds);
+
+  std::map<std::string, std::string> context{{"executable", "benchmarkScale"},
+      {"deviceaccess_version", CHIMERATK_DEVICEACCESS_VERSION},
+      {"properties", std::to_string(location->prop_nProperties.value())},
+      {"type_mix", location->prop_typeMix.value()}, {"array_size", std::to_string(location->prop_arraySize.value())},
+      {"zmq_rate", std::to_string(location->prop_zmqRate.value())}};
+  if(jsonFile.empty()) {
+    report.write(std::cout, context);
+  }
+  else {
+    std::ofstream f(jsonFile);
+    report.write(f, context);
+    std::cout << "Benchmark results written to " << jsonFile << std::endl;
+  }
+
+  return 0;
+}
@@ -7,14 +7,27 @@
 
 #pragma once
 
+#include "DoocsBackendAddressCache.h"
+#include "DoocsBackendAsyncWriter.h"
+#include "DoocsBackendLatencyTracing.h"
+#include "DoocsBackendPollScheduler.h"
+#include "DoocsBackendSnapshotCache.h"
+#include "DoocsBackendStatistics.h"
+#include "DoocsBackendThreadSettings.h"
+#include "DoocsBackendTimedRpc.h"
+#include "DoocsBackendVersionCache.h"
 #include "RegisterInfo.h"
 
 #include <ChimeraTK/async/DataConsistencyRealm.h>
 #include <ChimeraTK/DeviceBackendImpl.h>
 #include <ChimeraTK/VersionNumber.h>
 
+#include <atomic>
+#include <chrono>
 #include <future>
+#include <memory>
 #include <mutex>
+#include <vector>
 
 namespace ChimeraTK {
 
@@ -53,17 +66,104 @@ namespace ChimeraTK {
    * will be retrieved through standard RPC calls. Note that in either case a first read transfer is performed upon
    * creation of the accessor to make sure the property exists and the server is reachable, and to obtain the initial
    * value.
+   *
+   * If the parameter "statistics" is set to 1, the backend additionally provides the read-only registers below
+   * "/_stats" (e.g. "/_stats/rpc_latency_us"), which contain the counters and latency histograms collected by the
+   * backend (see DoocsBackendStatistics):
+   *
+   * (doocs:FACILITY/DEVICE/LOCATION?statistics=1)
+   *
+   * If the parameter "latencyTracing" is set to 1, the latencies along the ZeroMQ notification path are traced for all
+   * accessors using AccessMode::wait_for_new_data (see LatencyTracer). If additionally the parameter "traceFile" is
+   * specified, the trace is written to the given file in the Chrome trace-event JSON format when the backend is closed:
+   *
+   * (doocs:FACILITY/DEVICE/LOCATION?latencyTracing=1&traceFile=trace.json)
+   *
+   * If the parameter "asyncWrite" is set to 1, write() does not wait for the DOOCS server. The value is queued and sent
+   * by a background thread instead, and if a property is written again before the previous value has been sent, only
+   * the latest value is sent (write() then reports data loss). Failed writes put the backend into the exception state,
+   * so they are reported by the next transfer. Reading a property through RPC waits until pending writes to the same
+   * property have been sent, and close() waits until all pending writes have been sent:
+   *
+   * (doocs:FACILITY/DEVICE/LOCATION?asyncWrite=1)
+   *
+   * Writes affecting only a part of a property (partial array accessors, IIII elements and IFFF fields) are implemented
+   * as read-modify-write. If the parameter "rmwMaxAge" is set to a value in milliseconds, the read is skipped if a
+   * value of the property not older than the given age is known to the backend, e.g. from a ZeroMQ update or a previous
+   * read or write (see DoocsBackendSnapshotCache):
+   *
+   * (doocs:FACILITY/DEVICE/LOCATION?rmwMaxAge=1000)
+   *
+   * The backend keeps the DOOCS address structures of all properties it has accessed (see DoocsBackendAddressCache).
+   * open() connects to all locations used by existing accessors in parallel, so the first transfers after opening
+   * (and after recovering from an exception) do not pay the connection setup one after another. open() waits at most
+   * prewarmWaitTime for these connections, slow locations continue connecting in the background.
+   *
+   * If the parameter "recoveryProbe" is set to a timeout in milliseconds, open() only succeeds if all these locations
+   * respond within the timeout. Otherwise the first failing address is reported, so under partial outages open() fails
+   * right away instead of succeeding and failing again with the next transfer to a different server:
+   *
+   * (doocs:FACILITY/DEVICE/LOCATION?recoveryProbe=3000)
+   *
+   * If the parameter "rpcTimeoutMs" is set, RPC calls of the accessors and of the backend (see \ref rpc_timeout) fail
+   * with a runtime_error if the server does not reply within the given time in milliseconds, instead of waiting for the
+   * timeout of the DOOCS client library. The timeout can be changed per accessor with
+   * DoocsBackendRegisterAccessorBase::setRpcTimeout(). See also DoocsBackendRpcDeadline to bound the duration of e.g.
+   * a TransferGroup::read():
+   *
+   * (doocs:FACILITY/DEVICE/LOCATION?rpcTimeoutMs=500)
+   *
+   * If the parameter "pollPeriod" is set to a period in milliseconds, AccessMode::wait_for_new_data can also be used
+   * for properties without ZeroMQ publisher. These properties are then read periodically by a background thread of the
+   * backend, which pushes the values to the accessors like ZeroMQ updates (see DoocsBackendPollScheduler):
+   *
+   * (doocs:FACILITY/DEVICE/LOCATION?pollPeriod=1000)
+   *
+   * The properties of different locations are polled in parallel by one thread per location. The parameter
+   * "pollThreads" limits the number of these threads (default 8):
+   *
+   * (doocs:FACILITY/DEVICE/LOCATION?pollPeriod=1000&pollThreads=2)
+   *
+   * The parameters "zmqCpus", "zmqSchedPolicy" and "zmqPriority" set the CPU affinity and scheduling of the ZeroMQ
+   * receive threads of the DOOCS client library, which decode the updates and fill the queues of the accessors (see
+   * DoocsBackendThreadSettings). The CPUs are given as list with ranges, the policy is one of "other", "batch",
+   * "idle", "fifo" or "rr". A priority without policy selects "fifo". Since the threads are shared by all backends in
+   * the process, the settings of the first backend with a subscription on the thread are applied:
+   *
+   * (doocs:FACILITY/DEVICE/LOCATION?zmqCpus=2,3&zmqSchedPolicy=fifo&zmqPriority=50)
+   *
+   * If the parameter "zmqWorkers" is set to a number of threads, the ZeroMQ receive threads only copy each update once
+   * and hand it off to these decoding workers, which copy it into the queues of the accessors. This keeps the receive
+   * threads responsive when properties have many accessors, also across backends. The workers are shared by all
+   * backends in the process:
+   *
+   * (doocs:FACILITY/DEVICE/LOCATION?zmqWorkers=2)
+   *
+   * If the parameter "convertOnReceive" is set to 1, numeric accessors with AccessMode::wait_for_new_data receive the
+   * ZeroMQ updates already converted into their UserType, so read() only swaps buffers. The conversion is done once per
+   * update for all accessors with the same UserType and slice of a property, in the ZeroMQ receive thread resp. the
+   * decoding worker (see DoocsBackendRegisterAccessorBase::convertOnReceive):
+   *
+   * (doocs:FACILITY/DEVICE/LOCATION?convertOnReceive=1)
    */
   class DoocsBackend : public DeviceBackendImpl {
    public:
     ~DoocsBackend() override;
 
     DoocsBackend(const std::string& serverAddress, const std::string& cacheFile, const std::string& updateCache,
-        const std::string& dataConsistencyRealmName);
+        const std::string& dataConsistencyRealmName, bool enableStatistics = false, bool enableLatencyTracing = false,
+        const std::string& traceFile = "", bool enableAsyncWrite = false, std::chrono::milliseconds rmwMaxAge = {},
+        std::chrono::milliseconds recoveryProbeTimeout = {}, std::chrono::milliseconds rpcTimeout = {},
+        std::chrono::milliseconds pollPeriod = {}, DoocsBackendThreadSettings zmqThreadSettings = {},
+        size_t zmqWorkers = 0, bool convertOnReceive = false,
+        size_t pollThreads = DoocsBackendPollScheduler::defaultMaxThreads);
 
     RegisterCatalogue getRegisterCatalogue() const override;
 
-    const DoocsBackendRegisterCatalogue& getBackendRegisterCatalogue() const;
+    /** Obtain the current catalogue snapshot. If the catalogue is currently being fetched, this will block until the
+     *  fetching is complete. The snapshot is immutable, a new catalogue replaces the snapshot as a whole, so it is
+     *  safe to keep the returned pointer. */
+    std::shared_ptr<const DoocsBackendRegisterCatalogue> getBackendRegisterCatalogue() const;
 
     void open() override;
 
@@ -105,26 +205,99 @@ namespace ChimeraTK {
 
     std::atomic<bool> _asyncReadActivated{false};
 
-    VersionNumber getStartVersion() {
-      std::lock_guard<std::mutex> lk(_mxRecovery);
-      return _startVersion;
-    }
+    /// Instrumentation counters, updated by the accessors and the ZMQSubscriptionManager
+    DoocsBackendStatistics _statistics;
+
+    /// Latency tracing of the ZeroMQ notification path
+    LatencyTracer _latencyTracer;
+
+    /// Background sender for the asynchronous write mode, nullptr if writes are synchronous
+    std::unique_ptr<DoocsBackendAsyncWriter> _asyncWriter;
+
+    /// Recent property values for read-modify-write operations
+    DoocsBackendSnapshotCache _snapshotCache;
+
+    /// Address structures of the properties accessed through this backend
+    DoocsBackendAddressCache _addressCache;
+
+    /// Default timeout for RPC calls of the accessors, 0 if disabled (see DoocsBackendTimedRpc)
+    std::chrono::milliseconds _rpcTimeout;
+
+    /// Recent eventId to VersionNumber mappings of the _dataConsistencyRealm
+    std::unique_ptr<DoocsBackendVersionCache> _versionCache;
+
+    /// Polling of properties without ZeroMQ for AccessMode::wait_for_new_data, nullptr if disabled. Must be declared
+    /// after the members used by its thread.
+    std::unique_ptr<DoocsBackendPollScheduler> _pollScheduler;
+
+    /// CPU affinity and scheduling for the ZeroMQ receive threads, applied by the ZMQSubscriptionManager
+    const DoocsBackendThreadSettings _zmqThreadSettings;
+
+    /// Number of decoding workers for the ZeroMQ updates, 0 to process the updates in the DOOCS thread
+    const size_t _zmqWorkers;
+
+    /// Whether numeric accessors with AccessMode::wait_for_new_data convert the ZeroMQ updates on the receive side
+    const bool _convertOnReceive;
+
+    /// Minimum VersionNumber of data received since the last open(). Does not take _mxRecovery (the atomic shared_ptr
+    /// is not lock-free though, see _startVersion).
+    VersionNumber getStartVersion() const { return *_startVersion.load(std::memory_order_acquire); }
 
    private:
     std::string _cacheFile;
     std::promise<void> _cancelFlag{};
     mutable std::future<DoocsBackendRegisterCatalogue> _catalogueFuture;
-    mutable DoocsBackendRegisterCatalogue catalogue;
+    mutable std::shared_ptr<const DoocsBackendRegisterCatalogue> _catalogue;
+    /// Mutex for accessing _catalogueFuture and _catalogue
+    mutable std::mutex _mxCatalogue;
     bool _catalogueFromCache{false}; // controls whether open() might re-trigger catalogue filling
 
+    /// Whether the statistics registers are provided
+    bool _statisticsEnabled;
+
+    /// File name to write the latency trace to, empty if not requested
+    std::string _traceFile;
+
+    /// Write latency trace to _traceFile, if requested
+    void writeTraceFile() const noexcept;
+
+    /// Connection attempt to a location, see probeConnections()
+    struct ConnectionProbe {
+      std::string address;
+      std::future<DoocsBackendTimedRpc::AsyncResult> result;
+    };
+
+    /// Start connecting to all locations known to the _addressCache in parallel, on the workers of
+    /// DoocsBackendTimedRpc
+    std::vector<ConnectionProbe> probeConnections();
+
+    /// Wait for the given probes and store the resolved addresses. If the recovery probe is enabled, returns an error
+    /// message for the first location not responding within the _recoveryProbeTimeout and sets lastFailedAddress
+    /// accordingly (_mxRecovery must be locked). Otherwise waits at most prewarmWaitTime and returns an empty string,
+    /// errors are then reported by the transfers. Probes not finished in time continue in the background, their
+    /// results are discarded.
+    std::string evaluateConnectionProbes(std::vector<ConnectionProbe>& probes);
+
+    /// Maximum time open() waits for the connections to the locations if the recovery probe is disabled
+    static constexpr std::chrono::milliseconds prewarmWaitTime{200};
+
+    /// Timeout for the recovery probe in open(), 0 if disabled
+    std::chrono::milliseconds _recoveryProbeTimeout;
+
+    /// Create new catalogue snapshot from the given catalogue, adding the registers provided by the backend itself
+    std::shared_ptr<const DoocsBackendRegisterCatalogue> makeCatalogueSnapshot(
+        DoocsBackendRegisterCatalogue&& catalogue) const;
+
     bool cacheFileExists();
     bool isCachingEnabled() const;
 
-    /// Mutex for accessing  lastFailedAddress and _startVersion;
+    /// Mutex for accessing lastFailedAddress
     mutable std::mutex _mxRecovery;
 
-    /// VersionNumber generated in open() to make sure we do not violate TransferElement spec B.9.3.3.1/B.9.4.1
-    VersionNumber _startVersion{nullptr};
+    /// VersionNumber generated in open() to make sure we do not violate TransferElement spec B.9.3.3.1/B.9.4.1. It is
+    /// read for each received value, hence replaced atomically instead of being protected by _mxRecovery. With libstdc++
+    /// the atomic shared_ptr uses a short internal lock, which is not shared with other mutexes of the backend.
+    std::atomic<std::shared_ptr<const VersionNumber>> _startVersion{std::make_shared<const VersionNumber>(nullptr)};
 
     /// contains DOOCS address which triggered runtime_error, when _hasActiveException == true and _opend == true
     std::string lastFailedAddress;
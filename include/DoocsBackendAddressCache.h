@@ -0,0 +1,158 @@
+// SPDX-FileCopyrightText: Deutsches Elektronen-Synchrotron DESY, MSK, ChimeraTK Project <chimeratk-support@desy.de>
+// SPDX-License-Identifier: LGPL-3.0-or-later
+#pragma once
+
+#include <doocs/EqCall.h>
+
+#include <map>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace ChimeraTK {
+
+  /**
+   * DOOCS address structures of the properties used by a DoocsBackend. The EqAdr of an address is stored after a
+   * successful call, so the name resolution done by the DOOCS client library is not repeated for each temporary call
+   * (obtaining the type in getRegisterAccessor_impl(), the initial value poll of ZeroMQ subscriptions, the recovery
+   * check in open() etc.).
+   *
+   * The cache also knows which locations are used by the accessors of the backend, so open() can establish the
+   * connections to all of them in parallel before the first transfer (see getLocationAddresses()). Accessors register
+   * their address after they have been constructed successfully and keep the Registration until they are destroyed.
+   */
+  class DoocsBackendAddressCache {
+   public:
+    /// Registration of an address used by an accessor, see registerAddress(). Unregisters the address on destruction.
+    class Registration {
+     public:
+      Registration() = default;
+      Registration(Registration&& other) noexcept
+      : _cache(std::exchange(other._cache, nullptr)), _address(std::move(other._address)) {}
+      Registration& operator=(Registration&& other) noexcept {
+        if(this != &other) {
+          reset();
+          _cache = std::exchange(other._cache, nullptr);
+          _address = std::move(other._address);
+        }
+        return *this;
+      }
+      ~Registration() { reset(); }
+
+     private:
+      friend class DoocsBackendAddressCache;
+      Registration(DoocsBackendAddressCache* cache, std::string address) : _cache(cache), _address(std::move(address)) {}
+
+      void reset() noexcept {
+        if(_cache) _cache->unregisterAddress(_address);
+        _cache = nullptr;
+      }
+
+      DoocsBackendAddressCache* _cache{nullptr};
+      std::string _address;
+    };
+
+    /// Obtain address structure for the given address. Returns a copy of the cached one, if available.
+    doocs::EqAdr get(const std::string& address) {
+      {
+        std::lock_guard<std::mutex> lk(_mx);
+        auto it = _addresses.find(address);
+        if(it != _addresses.end() && it->second.resolved) {
+          return it->second.ea;
+        }
+      }
+      doocs::EqAdr ea;
+      ea.adr(address);
+      return ea;
+    }
+
+    /// Register the address of an accessor for getLocationAddresses(). The address is known until the last
+    /// Registration for it is destroyed.
+    [[nodiscard]] Registration registerAddress(const std::string& address) {
+      std::lock_guard<std::mutex> lk(_mx);
+      ++_addresses[address].nUsers;
+      return {this, address};
+    }
+
+    /// Whether any accessor has registered the given address
+    bool isRegistered(const std::string& address) const {
+      std::lock_guard<std::mutex> lk(_mx);
+      auto it = _addresses.find(address);
+      return it != _addresses.end() && it->second.nUsers > 0;
+    }
+
+    /// Store the address structure after it has been used successfully in a call
+    void update(const std::string& address, const doocs::EqAdr& ea) {
+      std::lock_guard<std::mutex> lk(_mx);
+      auto& entry = _addresses[address];
+      if(!entry.resolved) {
+        entry.ea = ea;
+        entry.resolved = true;
+      }
+    }
+
+    /// Forget the resolved address, e.g. after a communication error (the server might have moved to another host)
+    void invalidate(const std::string& address) {
+      std::lock_guard<std::mutex> lk(_mx);
+      auto it = _addresses.find(address);
+      if(it != _addresses.end()) {
+        it->second.resolved = false;
+        it->second.ea = {};
+      }
+    }
+
+    /// Remember that writes to the address are rejected by the server, see DoocsBackendAsyncWriter
+    void markReadOnly(const std::string& address) {
+      std::lock_guard<std::mutex> lk(_mx);
+      _addresses[address].readOnly = true;
+    }
+
+    /// Whether markReadOnly() has been called for the address
+    bool isReadOnly(const std::string& address) const {
+      std::lock_guard<std::mutex> lk(_mx);
+      auto it = _addresses.find(address);
+      return it != _addresses.end() && it->second.readOnly;
+    }
+
+    /// Obtain one known property address per location (i.e. per address without the property name)
+    std::vector<std::string> getLocationAddresses() const {
+      std::lock_guard<std::mutex> lk(_mx);
+      std::vector<std::string> result;
+      std::string lastLocation;
+      // the map is sorted, so addresses of the same location are adjacent
+      for(const auto& [address, entry] : _addresses) {
+        if(entry.nUsers == 0) continue;
+        auto location = address.substr(0, address.find_last_of('/'));
+        if(location == lastLocation) continue;
+        lastLocation = location;
+        result.push_back(address);
+      }
+      return result;
+    }
+
+   private:
+    struct Entry {
+      doocs::EqAdr ea;
+      bool resolved{false};
+
+      /// number of Registrations for the address
+      size_t nUsers{0};
+
+      /// set by markReadOnly()
+      bool readOnly{false};
+    };
+
+    void unregisterAddress(const std::string& address) noexcept {
+      std::lock_guard<std::mutex> lk(_mx);
+      auto it = _addresses.find(address);
+      if(it != _addresses.end() && --it->second.nUsers == 0) {
+        _addresses.erase(it);
+      }
+    }
+
+    mutable std::mutex _mx;
+    std::map<std::string, Entry> _addresses;
+  };
+
+} // namespace ChimeraTK
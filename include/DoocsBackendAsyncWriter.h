@@ -0,0 +1,78 @@
+// SPDX-FileCopyrightText: Deutsches Elektronen-Synchrotron DESY, MSK, ChimeraTK Project <chimeratk-support@desy.de>
+// SPDX-License-Identifier: LGPL-3.0-or-later
+#pragma once
+
+#include <doocs/EqCall.h>
+
+#include <condition_variable>
+#include <deque>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+
+namespace ChimeraTK {
+
+  class DoocsBackend;
+
+  /**
+   * Background sender for the asynchronous write mode of the DoocsBackend (CDD parameter asyncWrite=1).
+   *
+   * Writes are queued per DOOCS address and sent by a single background thread, in the order in which the addresses
+   * have been written first. Only the latest pending value per address is kept: if a new value is queued before the
+   * previous one has been sent, the previous value is replaced (coalesced). Properties written faster than the server
+   * can handle hence only receive the most recent value instead of building up a backlog.
+   *
+   * Failed writes are reported through the exception mechanism of the backend (informRuntimeError() and
+   * setException()), since the accessor which has queued the value has already returned from write(). Writes rejected
+   * because the property is read-only do not need a recovery: the address is marked read-only in the address cache
+   * instead, so the accessors become read-only like in the synchronous mode and further writes fail with a logic_error.
+   */
+  class DoocsBackendAsyncWriter {
+   public:
+    explicit DoocsBackendAsyncWriter(DoocsBackend& backend);
+
+    /// Stops the sender thread. Pending writes which have not yet been sent are discarded.
+    ~DoocsBackendAsyncWriter();
+
+    DoocsBackendAsyncWriter(const DoocsBackendAsyncWriter&) = delete;
+    DoocsBackendAsyncWriter& operator=(const DoocsBackendAsyncWriter&) = delete;
+
+    /// Queue the given data to be written to the given address. Returns true if a previously queued value for the
+    /// same address has been replaced without being sent.
+    bool enqueue(const std::string& address, const doocs::EqData& data);
+
+    /// Block until all values queued so far for the given address have been sent. If no address is given, wait until
+    /// all pending writes have been sent.
+    void flush(const std::string& address = {});
+
+    /// Discard all pending writes which have not yet been sent (e.g. when the backend goes into the exception state)
+    void discard();
+
+   private:
+    void run();
+
+    bool isPending(const std::string& address) const;
+
+    DoocsBackend& _backend;
+
+    /// mutex protecting all members below
+    std::mutex _mx;
+    std::condition_variable _cvWork;
+    std::condition_variable _cvDone;
+
+    /// latest pending value per address
+    std::map<std::string, doocs::EqData> _pending;
+
+    /// addresses in the order they have been queued, each address is contained only once
+    std::deque<std::string> _order;
+
+    /// address currently being sent, empty if idle
+    std::string _inFlight;
+
+    bool _stop{false};
+
+    std::thread _thread;
+  };
+
+} // namespace ChimeraTK
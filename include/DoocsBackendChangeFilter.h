@@ -0,0 +1,250 @@
+// SPDX-FileCopyrightText: Deutsches Elektronen-Synchrotron DESY, MSK, ChimeraTK Project <chimeratk-support@desy.de>
+// SPDX-License-Identifier: LGPL-3.0-or-later
+#pragma once
+
+#include <doocs/EqData.h>
+
+#include <eq_types.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <mutex>
+
+namespace ChimeraTK {
+
+  /**
+   * Filter for the updates pushed into the notification queue of an accessor with AccessMode::wait_for_new_data (see
+   * DoocsBackendRegisterAccessorBase::enableChangeFilter(), setDeadband() and setDecimation()). The filter is applied
+   * before the data is copied for the queue, so dropped updates are cheap.
+   *
+   * Change detection / deadband: updates are dropped if the payload is equal to the last update let through. Numeric
+   * values are considered equal if they differ by at most the absolute deadband, or by at most the relative deadband
+   * times the previous value. Without deadband, arrays are compared with memcmp(). Event id and time stamp are not
+   * compared, so values which are republished by DOOCS without change are dropped even though they carry a new event
+   * id. Updates with a different error code are always let through, as are data types without specific comparison
+   * (IIII, IFFF, images etc.).
+   *
+   * Decimation: updates are dropped unless at least everyNth updates have been received and at least minInterval has
+   * passed since the last update let through.
+   */
+  class DoocsBackendChangeFilter {
+   public:
+    struct Deadband {
+      double absolute{0.};
+      double relative{0.};
+    };
+
+    /// Check whether the update shall be pushed. If so, it is remembered for the comparison with the next update.
+    bool accept(const doocs::EqData& data) {
+      std::lock_guard<std::mutex> lk(_mx);
+      ++_receivedSinceLast;
+      if(_hasPrevious) {
+        bool drop = _receivedSinceLast < _everyNth;
+        if(!drop && _minInterval.count() > 0) {
+          drop = std::chrono::steady_clock::now() - _lastTime < _minInterval;
+        }
+        if(!drop && _compare) {
+          drop = isEqual(_previous, data, _deadband);
+        }
+        if(drop) {
+          _suppressedCount.fetch_add(1, std::memory_order_relaxed);
+          return false;
+        }
+      }
+      // keep the payload only if needed for the comparison
+      if(_compare) remember(data);
+      if(_minInterval.count() > 0) _lastTime = std::chrono::steady_clock::now();
+      _receivedSinceLast = 0;
+      _hasPrevious = true;
+      return true;
+    }
+
+    /// Forget the last update, so the next one is let through (e.g. the initial value after activateAsyncRead())
+    void reset() {
+      std::lock_guard<std::mutex> lk(_mx);
+      _hasPrevious = false;
+    }
+
+    /// Enable change detection with the given deadband
+    void setDeadband(Deadband deadband) {
+      std::lock_guard<std::mutex> lk(_mx);
+      // no previous value to compare with yet: let the next update through
+      if(!_compare) _hasPrevious = false;
+      _compare = true;
+      _deadband = deadband;
+    }
+
+    /// Let through only every Nth update, with at least the given interval in between (1 resp. 0 to disable)
+    void setDecimation(size_t everyNth, std::chrono::milliseconds minInterval) {
+      std::lock_guard<std::mutex> lk(_mx);
+      _everyNth = std::max(everyNth, size_t(1));
+      _minInterval = minInterval;
+    }
+
+    /// Number of updates dropped by the filter
+    size_t getSuppressedCount() const { return _suppressedCount.load(std::memory_order_relaxed); }
+
+    /// Compare the payload of two DOOCS data objects exactly
+    static bool isEqual(const doocs::EqData& a, const doocs::EqData& b) { return isEqual(a, b, Deadband()); }
+
+    /// Compare the payload of two DOOCS data objects. The relative deadband refers to the values of a.
+    static bool isEqual(const doocs::EqData& a, const doocs::EqData& b, Deadband deadband) {
+      if(a.type() != b.type() || a.error() != b.error() || a.length() != b.length()) return false;
+      auto n = a.length();
+      bool exact = deadband.absolute <= 0 && deadband.relative <= 0;
+
+      auto equalMemory = [&](const auto* pa, const auto* pb) {
+        return n == 0 || (pa && pb && std::memcmp(pa, pb, size_t(n) * sizeof(*pa)) == 0);
+      };
+      auto withinDeadband = [&](double va, double vb) {
+        return va == vb || std::abs(va - vb) <= std::max(deadband.absolute, deadband.relative * std::abs(va));
+      };
+
+      switch(a.type()) {
+        case DATA_BOOL:
+        case DATA_SHORT:
+        case DATA_USHORT:
+        case DATA_INT:
+        case DATA_UINT:
+        case DATA_LONG:
+          if(exact) return a.get_long() == b.get_long();
+          return withinDeadband(double(a.get_long()), double(b.get_long()));
+
+        case DATA_ULONG:
+          if(exact) return a.get_ulong() == b.get_ulong();
+          return withinDeadband(double(a.get_ulong()), double(b.get_ulong()));
+
+        case DATA_FLOAT:
+        case DATA_DOUBLE:
+          return withinDeadband(a.get_double(), b.get_double());
+
+        case DATA_STRING:
+        case DATA_TEXT:
+          return a.get_string() == b.get_string();
+
+        case DATA_A_SHORT:
+        case DATA_A_USHORT:
+          if(exact) return equalMemory(a.get_short_array(), b.get_short_array());
+          break;
+
+        case DATA_A_INT:
+        case DATA_A_UINT:
+          if(exact) return equalMemory(a.get_int_array(), b.get_int_array());
+          break;
+
+        case DATA_A_LONG:
+        case DATA_A_ULONG:
+          if(exact) return equalMemory(a.get_long_array(), b.get_long_array());
+          break;
+
+        case DATA_A_BYTE:
+          if(exact) return equalMemory(a.get_char_array(), b.get_char_array());
+          break;
+
+        case DATA_A_FLOAT:
+        case DATA_SPECTRUM:
+          if(exact) return equalMemory(a.get_float_array(), b.get_float_array());
+          break;
+
+        case DATA_A_DOUBLE:
+          if(exact) return equalMemory(a.get_double_array(), b.get_double_array());
+          break;
+
+        case DATA_A_BOOL:
+          for(int i = 0; i < n; ++i) {
+            if(a.get_bool(i) != b.get_bool(i)) return false;
+          }
+          return true;
+
+        case DATA_GSPECTRUM:
+          break;
+
+        default:
+          return false;
+      }
+
+      // numeric arrays and spectra with deadband
+      if(a.type() == DATA_A_BYTE) {
+        // signed 8 bit values
+        auto* pa = reinterpret_cast<const int8_t*>(a.get_char_array());
+        auto* pb = reinterpret_cast<const int8_t*>(b.get_char_array());
+        if(!pa || !pb) return n == 0;
+        for(int i = 0; i < n; ++i) {
+          if(!withinDeadband(pa[i], pb[i])) return false;
+        }
+        return true;
+      }
+      bool isFloat = a.type() == DATA_A_FLOAT || a.type() == DATA_SPECTRUM || a.type() == DATA_GSPECTRUM;
+      for(int i = 0; i < n; ++i) {
+        if(isFloat ? !withinDeadband(a.get_float(i), b.get_float(i)) :
+                     !withinDeadband(a.get_double(i), b.get_double(i))) {
+          return false;
+        }
+      }
+      return true;
+    }
+
+   private:
+    /// Store the payload of data in _previous for the next comparison. Numeric arrays are copied into the buffer of
+    /// _previous if type, length and error code are unchanged, so no allocation is needed in steady state.
+    void remember(const doocs::EqData& data) {
+      if(_previous.type() == data.type() && _previous.length() == data.length() && _previous.error() == data.error()) {
+        auto n = size_t(data.length());
+        auto copy = [&](auto* dst, const auto* src) {
+          if(!dst || !src) return false;
+          std::memcpy(dst, src, n * sizeof(*src));
+          return true;
+        };
+        bool copied = false;
+        switch(data.type()) {
+          case DATA_A_SHORT:
+          case DATA_A_USHORT:
+            copied = copy(_previous.get_short_array(), data.get_short_array());
+            break;
+          case DATA_A_INT:
+          case DATA_A_UINT:
+            copied = copy(_previous.get_int_array(), data.get_int_array());
+            break;
+          case DATA_A_LONG:
+          case DATA_A_ULONG:
+            copied = copy(_previous.get_long_array(), data.get_long_array());
+            break;
+          case DATA_A_BYTE:
+            copied = copy(_previous.get_char_array(), data.get_char_array());
+            break;
+          case DATA_A_FLOAT:
+          case DATA_SPECTRUM:
+            copied = copy(_previous.get_float_array(), data.get_float_array());
+            break;
+          case DATA_A_DOUBLE:
+            copied = copy(_previous.get_double_array(), data.get_double_array());
+            break;
+          default:
+            break;
+        }
+        if(copied) return;
+      }
+      _previous = data;
+    }
+
+    std::atomic<size_t> _suppressedCount{0};
+
+    /// mutex protecting the members below (updates may be pushed by different threads, e.g. the ZeroMQ callback and
+    /// the initial value poll)
+    std::mutex _mx;
+
+    bool _compare{false};
+    Deadband _deadband;
+    size_t _everyNth{1};
+    std::chrono::milliseconds _minInterval{0};
+
+    doocs::EqData _previous;
+    std::chrono::steady_clock::time_point _lastTime;
+    size_t _receivedSinceLast{0};
+    bool _hasPrevious{false};
+  };
+
+} // namespace ChimeraTK
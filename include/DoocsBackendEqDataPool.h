@@ -0,0 +1,170 @@
+// SPDX-FileCopyrightText: Deutsches Elektronen-Synchrotron DESY, MSK, ChimeraTK Project <chimeratk-support@desy.de>
+// SPDX-License-Identifier: LGPL-3.0-or-later
+#pragma once
+
+#include <doocs/EqCall.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace ChimeraTK {
+
+  /**
+   * Pool of reusable doocs::EqData buffers for the ZeroMQ notifications. The pool of a ZeroMQ subscription is shared by
+   * all its accessors, polled accessors have their own pool. The buffers are allocated on demand with the type and
+   * length of the property (from the catalogue resp. the server), so copying an update into a buffer does not allocate
+   * as long as the length of the property does not grow.
+   *
+   * The ZeroMQ callback acquires a buffer, copies the received data into it and pushes it through the notification
+   * queue. The accessor swaps the buffer with its dst and the Handle returns the buffer (now holding the previous
+   * content of dst) to the pool. Hence no heap allocation is required in the notification path in steady state.
+   *
+   * The pool keeps at most maxBuffers buffers (see setMaxBuffers()). If all of them are in use, a temporary buffer is
+   * allocated, which is freed again when its Handle is released. Hence the memory held by idle pools stays bounded.
+   */
+  class DoocsBackendEqDataPool : public std::enable_shared_from_this<DoocsBackendEqDataPool> {
+   public:
+    /** Buffer taken from the pool. The buffer is returned to the pool when the handle is destroyed or reset. */
+    class Handle {
+     public:
+      Handle() = default;
+      Handle(Handle&& other) noexcept
+      : _pool(std::move(other._pool)), _data(other._data), _temporary(other._temporary) {
+        other._data = nullptr;
+      }
+      Handle& operator=(Handle&& other) noexcept {
+        if(this != &other) {
+          reset();
+          _pool = std::move(other._pool);
+          _data = other._data;
+          _temporary = other._temporary;
+          other._data = nullptr;
+        }
+        return *this;
+      }
+      Handle(const Handle&) = delete;
+      Handle& operator=(const Handle&) = delete;
+      ~Handle() { reset(); }
+
+      doocs::EqData& operator*() const { return *_data; }
+      doocs::EqData* operator->() const { return _data; }
+      explicit operator bool() const { return _data != nullptr; }
+
+      /// Return the buffer to the pool
+      void reset() noexcept {
+        if(_data) {
+          _pool->release(_data, _temporary);
+          _data = nullptr;
+        }
+        _pool.reset();
+      }
+
+     private:
+      friend class DoocsBackendEqDataPool;
+      Handle(std::shared_ptr<DoocsBackendEqDataPool> pool, doocs::EqData* data, bool temporary)
+      : _pool(std::move(pool)), _data(data), _temporary(temporary) {}
+
+      std::shared_ptr<DoocsBackendEqDataPool> _pool;
+      doocs::EqData* _data{nullptr};
+      bool _temporary{false};
+    };
+
+    /**
+     * Create an empty pool keeping up to maxBuffers buffers of the given DOOCS type and length. The onAllocate function
+     * is called for each allocated buffer, e.g. to count the allocations in the statistics.
+     */
+    static std::shared_ptr<DoocsBackendEqDataPool> create(
+        size_t maxBuffers, int typeId, size_t length, std::function<void()> onAllocate = {}) {
+      // constructor is private to enforce the use of shared_ptr (required by Handle)
+      return std::shared_ptr<DoocsBackendEqDataPool>(
+          new DoocsBackendEqDataPool(maxBuffers, typeId, length, std::move(onAllocate)));
+    }
+
+    /// Take a buffer from the pool. The content of the buffer is undefined.
+    Handle acquire() {
+      bool allocated;
+      return acquire(allocated);
+    }
+
+    /// Take a buffer from the pool and report whether a buffer had to be allocated.
+    Handle acquire(bool& allocated) {
+      std::lock_guard<std::mutex> lk(_mx);
+      allocated = _free.empty();
+      if(allocated) {
+        if(_onAllocate) _onAllocate();
+        if(_buffers.size() >= _maxBuffers) {
+          return {shared_from_this(), makeBuffer().release(), true};
+        }
+        // reserve capacity for all buffers, so release() never allocates
+        _free.reserve(_buffers.size() + 1);
+        _buffers.push_back(makeBuffer());
+        _free.push_back(_buffers.back().get());
+      }
+      auto* data = _free.back();
+      _free.pop_back();
+      return {shared_from_this(), data, false};
+    }
+
+    /// Change the maximum number of buffers kept. Buffers above the limit are freed when they are released.
+    void setMaxBuffers(size_t maxBuffers) {
+      std::lock_guard<std::mutex> lk(_mx);
+      _maxBuffers = maxBuffers;
+      while(_buffers.size() > _maxBuffers && !_free.empty()) {
+        remove(_free.back());
+        _free.pop_back();
+      }
+    }
+
+    /// Number of buffers kept by this pool (including the buffers in use, excluding temporary buffers)
+    size_t getNumberOfBuffers() const {
+      std::lock_guard<std::mutex> lk(_mx);
+      return _buffers.size();
+    }
+
+   private:
+    DoocsBackendEqDataPool(size_t maxBuffers, int typeId, size_t length, std::function<void()> onAllocate)
+    : _maxBuffers(maxBuffers), _typeId(typeId), _length(length), _onAllocate(std::move(onAllocate)) {}
+
+    std::unique_ptr<doocs::EqData> makeBuffer() const {
+      auto buffer = std::make_unique<doocs::EqData>();
+      if(_typeId != 0) {
+        buffer->set_type(_typeId);
+        if(_length > 1) buffer->length(int(_length));
+      }
+      return buffer;
+    }
+
+    /// Free a buffer of the pool. precondition: _mx must be locked
+    void remove(doocs::EqData* data) noexcept {
+      auto it = std::find_if(_buffers.begin(), _buffers.end(), [&](const auto& b) { return b.get() == data; });
+      if(it != _buffers.end()) _buffers.erase(it);
+    }
+
+    void release(doocs::EqData* data, bool temporary) noexcept {
+      if(temporary) {
+        delete data;
+        return;
+      }
+      std::lock_guard<std::mutex> lk(_mx);
+      if(_buffers.size() > _maxBuffers) {
+        remove(data);
+        return;
+      }
+      _free.push_back(data);
+    }
+
+    size_t _maxBuffers;
+    int _typeId;
+    size_t _length;
+    std::function<void()> _onAllocate;
+
+    mutable std::mutex _mx;
+    std::vector<std::unique_ptr<doocs::EqData>> _buffers;
+    std::vector<doocs::EqData*> _free;
+  };
+
+} // namespace ChimeraTK
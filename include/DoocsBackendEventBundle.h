@@ -0,0 +1,94 @@
+// SPDX-FileCopyrightText: Deutsches Elektronen-Synchrotron DESY, MSK, ChimeraTK Project <chimeratk-support@desy.de>
+// SPDX-License-Identifier: LGPL-3.0-or-later
+#pragma once
+
+#include "DoocsBackendRegisterAccessor.h"
+
+#include <ChimeraTK/TransferElementAbstractor.h>
+
+#include <boost/weak_ptr.hpp>
+
+#include <atomic>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <vector>
+
+namespace ChimeraTK {
+
+  /**
+   * Aligns the ZeroMQ updates of several accessors by their DOOCS eventId (macro pulse number).
+   *
+   * Updates received for the accessors of a bundle are not pushed into the accessors' queues right away. They are
+   * buffered per eventId until all accessors have received the update for that eventId, and then pushed into the
+   * queues of all accessors together. Hence after reading one accessor of the bundle, the other accessors have an
+   * update with the same eventId in their queues, and read() reads such a complete set.
+   *
+   * Updates are buffered for at most window eventIds. If the window is exceeded, the oldest eventId is dropped. When a
+   * set is completed, older incomplete sets are dropped as well, since the matching updates cannot arrive any more
+   * (DOOCS sends eventIds in increasing order). The number of dropped incomplete sets can be obtained with
+   * getIncompleteCount().
+   *
+   * Exceptions and the initial values are not aligned, they are pushed into the queues directly. Updates without
+   * eventId (eventId 0) are pushed directly as well.
+   *
+   * All accessors must be obtained from DoocsBackend instances with AccessMode::wait_for_new_data. They should be added
+   * before activateAsyncRead() is called, updates already in the queues are not aligned. The accessors keep the bundle
+   * alive, while the bundle does not own the accessors.
+   */
+  class DoocsBackendEventBundle : public std::enable_shared_from_this<DoocsBackendEventBundle> {
+   public:
+    /// Create bundle buffering updates for at most window eventIds
+    static std::shared_ptr<DoocsBackendEventBundle> create(size_t window = 16);
+
+    /// Add accessor to the bundle. Throws ChimeraTK::logic_error if the accessor is not suitable.
+    void add(TransferElementAbstractor& accessor);
+
+    /// Read one complete set: wait for the next update of the first accessor, then read all other accessors. Throws
+    /// ChimeraTK::logic_error if an accessor of the bundle no longer exists.
+    void read();
+
+    /// Number of eventIds dropped before the updates of all accessors have been received
+    size_t getIncompleteCount() const { return _incompleteCount.load(std::memory_order_relaxed); }
+
+    /// Called by the ZMQSubscriptionManager for updates of accessors belonging to this bundle
+    void push(DoocsBackendRegisterAccessorBase* accessor, DoocsBackendNotification&& notification);
+
+    /// Called by accessors belonging to this bundle when they are shut down
+    void remove(DoocsBackendRegisterAccessorBase* accessor);
+
+    /// Called by the ZMQSubscriptionManager when the accessors are activated again (after open()). Drops the pending
+    /// sets and forgets the last eventId, since the eventIds may start again lower e.g. after a restart of the server.
+    void reset();
+
+   private:
+    explicit DoocsBackendEventBundle(size_t window) : _window(window) {}
+
+    /// Remove the oldest pending eventId and count it as incomplete. Precondition: _mx is locked.
+    void dropOldest();
+
+    size_t _window;
+
+    /// mutex protecting the members below
+    std::mutex _mx;
+
+    /// low-level accessors, the index is the position of the update in _pending
+    std::vector<DoocsBackendRegisterAccessorBase*> _members;
+
+    /// high-level elements of the accessors as added by the user, used by read() (same order as _members)
+    std::vector<boost::weak_ptr<TransferElement>> _elements;
+
+    struct PendingSet {
+      std::vector<std::optional<DoocsBackendNotification>> updates;
+      size_t nReceived{0};
+    };
+    std::map<doocs::EventId, PendingSet> _pending;
+
+    /// last eventId which has been delivered or dropped, updates for older eventIds are discarded
+    doocs::EventId _lastEventId;
+
+    std::atomic<size_t> _incompleteCount{0};
+  };
+
+} // namespace ChimeraTK
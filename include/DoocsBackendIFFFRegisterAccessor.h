@@ -39,7 +39,8 @@ namespace ChimeraTK {
       return true;
     }
 
-    enum class Field { I, F1, F2, F3 };
+    /// Fields of the IFFF structure, the values are used as unit index of the raw element
+    enum class Field { I = 0, F1 = 1, F2 = 2, F3 = 3 };
     Field field;
 
     using NDRegisterAccessor<UserType>::buffer_2D;
@@ -87,6 +88,11 @@ namespace ChimeraTK {
         throw ChimeraTK::logic_error("DOOCS data type " + std::to_string(src.type()) +
             " not supported by DoocsBackendIFFFRegisterAccessor."); // LCOV_EXCL_LINE (already prevented in the Backend)
       }
+
+      // Transfer the whole property through the raw element, which is shared with the accessors for the other fields
+      // in a TransferGroup. Hence all fields are transferred with a single RPC call.
+      auto unit = static_cast<size_t>(field);
+      this->useRawElement(4, unit, unit + 1);
     }
     catch(...) {
       this->shutdown();
@@ -109,7 +115,7 @@ namespace ChimeraTK {
     if(!hasNewData) return;
 
     // copy data into our buffer
-    IFFF* data = dst.get_ifff();
+    IFFF* data = this->readBuffer().get_ifff();
     switch(field) {
       case Field::I: {
         buffer_2D[0][0] = numericToUserType<UserType>(data->i1_data);
@@ -137,13 +143,14 @@ namespace ChimeraTK {
 
   template<typename UserType>
   void DoocsBackendIFFFRegisterAccessor<UserType>::doPreWrite(TransferType type, VersionNumber version) {
+    // the raw element performs the read-modify-write, create it on the first write if not yet in a TransferGroup
+    this->createRawElement();
     DoocsBackendRegisterAccessor<UserType>::doPreWrite(type, version);
 
-    // read-modify-write: first read
-    DoocsBackendRegisterAccessor<UserType>::doReadTransferSynchronously();
-
-    // now modify
-    IFFF* data = dst.get_ifff();
+    // Modify our field in the raw element. The other fields have been filled in by the raw element with the current
+    // value of the property (read-modify-write), unless they are written in the same transaction by other accessors
+    // sharing the raw element.
+    IFFF* data = this->writeBuffer().get_ifff();
     switch(field) {
       case Field::I: {
         data->i1_data = userTypeToNumeric<int>(buffer_2D[0][0]);
@@ -165,9 +172,6 @@ namespace ChimeraTK {
         assert(false); // LCOV_EXCL_LINE (cannot happen, see constructor)
       }
     }
-
-    // prepare for writing
-    src.set(data);
   }
 
 } // namespace ChimeraTK
@@ -0,0 +1,138 @@
+// SPDX-FileCopyrightText: Deutsches Elektronen-Synchrotron DESY, MSK, ChimeraTK Project <chimeratk-support@desy.de>
+// SPDX-License-Identifier: LGPL-3.0-or-later
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace ChimeraTK {
+
+  /********************************************************************************************************************/
+
+  /**
+   * Time stamps of a single update along the ZeroMQ notification path. Wall clock times are in microseconds since the
+   * epoch, so they can be compared with the time stamp attached by the DOOCS server. The durations within the backend
+   * are measured with the monotonic clock.
+   */
+  struct NotificationTrace {
+    /// time stamp of the data as sent by the DOOCS server (ZeroMQ header), 0 if unknown
+    int64_t serverTimeUs{0};
+
+    /// wall clock time of the arrival in ZMQSubscriptionManager::zmq_callback(), 0 if the update is not traced
+    int64_t callbackTimeUs{0};
+
+    /// monotonic time of the arrival in the callback and of pushing the update into the notification queue
+    std::chrono::steady_clock::time_point callback, enqueued;
+
+    [[nodiscard]] bool isValid() const { return callbackTimeUs != 0; }
+  };
+
+  /********************************************************************************************************************/
+
+  /** Latency percentiles of one stage of the notification path, in microseconds */
+  struct LatencyPercentiles {
+    int64_t p50{0};
+    int64_t p90{0};
+    int64_t p99{0};
+    int64_t max{0};
+  };
+
+  /** Latency report of a single accessor, computed over the most recent updates */
+  struct LatencyReport {
+    std::string path;
+
+    /// number of updates the percentiles are computed from
+    size_t count{0};
+
+    /// DOOCS server time stamp to arrival in the callback. Depends on the clock synchronisation with the server!
+    LatencyPercentiles serverToCallback;
+    /// arrival in the callback to being pushed into the notification queue
+    LatencyPercentiles callbackToEnqueue;
+    /// being pushed into the notification queue to the read() of the accessor returning
+    LatencyPercentiles enqueueToRead;
+    /// DOOCS server time stamp to the read() returning
+    LatencyPercentiles total;
+  };
+
+  /********************************************************************************************************************/
+
+  /**
+   * Latency tracing of the ZeroMQ notification path of a DoocsBackend. Each accessor using AccessMode::wait_for_new_data
+   * obtains a Channel, into which the completed traces are recorded when read() returns. The channel keeps the
+   * latencies of the most recent updates to compute percentiles, while the tracer keeps a bounded list of events which
+   * can be exported in the Chrome trace-event JSON format (to be viewed e.g. with chrome://tracing or Perfetto).
+   *
+   * Tracing is disabled by default and costs only a flag check per update in that case: the ZeroMQ callback takes the
+   * time stamps only if a listener of the subscription belongs to a backend with tracing enabled.
+   */
+  class LatencyTracer {
+   public:
+    /// number of updates per channel used to compute the percentiles
+    static constexpr size_t samplesPerChannel = 1024;
+
+    class Channel {
+     public:
+      Channel(LatencyTracer& tracer, uint32_t id, std::string path);
+
+      /// Record the completed trace of an update. readReturned is the (monotonic) time when the read() completed.
+      void record(const NotificationTrace& trace, std::chrono::steady_clock::time_point readReturned);
+
+      [[nodiscard]] LatencyReport getReport() const;
+
+     private:
+      LatencyTracer& _tracer;
+      uint32_t _id;
+      std::string _path;
+
+      mutable std::mutex _mx;
+      size_t _count{0};
+      std::vector<int64_t> _serverToCallback, _callbackToEnqueue, _enqueueToRead, _total;
+    };
+
+    /// Enable tracing, keeping at most maxEvents events for the trace export.
+    void enable(size_t maxEvents = 100000);
+
+    [[nodiscard]] bool isEnabled() const { return _enabled.load(std::memory_order_relaxed); }
+
+    /// Create a channel for an accessor. Returns nullptr if tracing is disabled.
+    std::shared_ptr<Channel> createChannel(const std::string& path);
+
+    /// Obtain the latency reports of all accessors which are still alive
+    [[nodiscard]] std::vector<LatencyReport> getReports() const;
+
+    /// Write the recorded events in the Chrome trace-event JSON format
+    void writeChromeTrace(std::ostream& os) const;
+
+    /// Convenience function to write the Chrome trace into the given file
+    void writeChromeTrace(const std::string& fileName) const;
+
+    /// Start a trace in the callback function. serverSec and serverUsec are the time stamp of the ZeroMQ header.
+    static NotificationTrace begin(int64_t serverSec, int64_t serverUsec);
+
+   private:
+    struct Event {
+      uint32_t channel;
+      int64_t serverTimeUs, callbackTimeUs, enqueuedTimeUs, readTimeUs;
+    };
+
+    void addEvent(const Event& event);
+
+    std::atomic<bool> _enabled{false};
+
+    mutable std::mutex _mx;
+    size_t _maxEvents{0};
+    std::deque<Event> _events;
+    std::vector<std::string> _channelNames;
+    std::vector<std::weak_ptr<Channel>> _channels;
+  };
+
+  /********************************************************************************************************************/
+
+} // namespace ChimeraTK
@@ -0,0 +1,165 @@
+// SPDX-FileCopyrightText: Deutsches Elektronen-Synchrotron DESY, MSK, ChimeraTK Project <chimeratk-support@desy.de>
+// SPDX-License-Identifier: LGPL-3.0-or-later
+#pragma once
+
+#include "DoocsBackendTimedRpc.h"
+
+#include <doocs/EqCall.h>
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace ChimeraTK {
+
+  class DoocsBackend;
+  class DoocsBackendRegisterAccessorBase;
+
+  /**
+   * Polling mode of the DoocsBackend for properties without ZeroMQ publisher (CDD parameter pollPeriod).
+   *
+   * Accessors with AccessMode::wait_for_new_data for such properties register with the scheduler instead of the
+   * ZMQSubscriptionManager. A background thread reads all registered properties once per period and pushes the
+   * results into the notification queues of the accessors, as the ZeroMQ callback does. Each property is read once per
+   * period, independent of the number of accessors. The thread is started when the first accessor is added.
+   *
+   * The reads of one period are shared between this thread and additional poller threads, one per location (server)
+   * with polled properties, up to maxThreads in total (CDD parameter pollThreads). Reads of different locations hence
+   * run in parallel. The pollers are started when accessors of further locations are added and exist as long as the
+   * scheduler does.
+   *
+   * Polling is only performed while asynchronous reads are activated. Communication errors are pushed as exceptions
+   * into the queues of the affected accessors and reported to the backend through informRuntimeError(). No further
+   * values are pushed until the backend has been recovered and activateAsyncRead() has been called again.
+   */
+  class DoocsBackendPollScheduler {
+   public:
+    /// No threads are started before the first add()
+    DoocsBackendPollScheduler(
+        DoocsBackend& backend, std::chrono::milliseconds period, size_t maxThreads = defaultMaxThreads);
+
+    /// Stops the polling threads
+    ~DoocsBackendPollScheduler();
+
+    DoocsBackendPollScheduler(const DoocsBackendPollScheduler&) = delete;
+    DoocsBackendPollScheduler& operator=(const DoocsBackendPollScheduler&) = delete;
+
+    /// Register accessor to receive the polled values of its property
+    void add(DoocsBackendRegisterAccessorBase* accessor);
+
+    /// Unregister accessor. After returning, no more values will be pushed into its queue.
+    void remove(DoocsBackendRegisterAccessorBase* accessor);
+
+    /// Start polling, called by DoocsBackend::activateAsyncRead(). The first poll is done right away and provides the
+    /// initial values.
+    void activate();
+
+    /// Stop polling, called by DoocsBackend::close()
+    void deactivate();
+
+    /// Stop polling and push the given exception into the queues of all accessors, called by setException()
+    void deactivateAndPushException(const std::string& message);
+
+    /// Default for the maximum number of threads reading in parallel, including the scheduler thread
+    static constexpr size_t defaultMaxThreads = 8;
+
+   private:
+    struct Property {
+      explicit Property(const std::string& address) : eq(address) {}
+      doocs::EqAdr ea;
+      DoocsBackendTimedRpc eq;
+      std::vector<DoocsBackendRegisterAccessorBase*> listeners;
+
+      /// whether an exception has been pushed to the listeners since the last activate()
+      bool hasException{false};
+    };
+
+    struct Result {
+      std::string path;
+      std::shared_ptr<Property> property;
+      int rc{0};
+      bool failed{false};
+      doocs::EqData dst;
+      std::string errorMessage;
+    };
+
+    void run();
+
+    /// Thread function of the poller threads, which help run() with the reads of each period
+    void runPoller();
+
+    /// Read the properties of the current period until none is left (called concurrently by run() and the pollers)
+    void pollAll(std::vector<Result>& results);
+
+    /// Read the given property (called concurrently for different properties)
+    void poll(Result& result);
+
+    /// Push exception into the queues of the listeners of the property, unless already done. _mx must be locked.
+    void pushException(Property& property, const std::string& message);
+
+    /// Push the results into the queues of the accessors, if the polling is still active in the given generation
+    void distribute(std::vector<Result>& results, size_t generation);
+
+    /// Location of the property address (the address without the property name)
+    static std::string getLocation(const std::string& path);
+
+    /// Start the scheduler thread resp. further pollers as required by the registered locations. _mx must be locked.
+    void startThreads();
+
+    DoocsBackend& _backend;
+    std::chrono::milliseconds _period;
+    size_t _maxThreads;
+
+    /// mutex protecting all members below
+    std::mutex _mx;
+    std::condition_variable _cv;
+
+    /// registered properties by address. Properties are held through shared_ptr, so a read can complete while the
+    /// last accessor of the property is being removed.
+    std::map<std::string, std::shared_ptr<Property>> _properties;
+
+    /// number of registered properties per location
+    std::map<std::string, size_t> _locations;
+
+    bool _active{false};
+
+    /// incremented on each deactivation, so values read before the deactivation are discarded
+    size_t _generation{0};
+
+    /// set by activate() to start the next poll immediately
+    bool _pollNow{false};
+
+    bool _stop{false};
+
+    std::thread _thread;
+
+    /// mutex protecting the members below, which hand the reads of a period over to the poller threads
+    std::mutex _mxWork;
+    std::condition_variable _cvWork;
+    std::condition_variable _cvWorkDone;
+
+    /// results to be filled in the current period, nullptr if there is no work for the pollers
+    std::vector<Result>* _work{nullptr};
+
+    /// incremented for each period handed over to the pollers, so each poller takes part at most once per period
+    size_t _round{0};
+
+    /// number of pollers currently reading properties of _work
+    size_t _nBusy{0};
+
+    bool _stopPollers{false};
+
+    /// index of the next property of _work to read, shared by all threads reading
+    std::atomic<size_t> _nextWork{0};
+
+    /// poller threads, only changed by add() while holding _mx
+    std::vector<std::thread> _pollers;
+  };
+
+} // namespace ChimeraTK
@@ -0,0 +1,121 @@
+// SPDX-FileCopyrightText: Deutsches Elektronen-Synchrotron DESY, MSK, ChimeraTK Project <chimeratk-support@desy.de>
+// SPDX-License-Identifier: LGPL-3.0-or-later
+#pragma once
+
+#include "DoocsBackendTimedRpc.h"
+
+#include <ChimeraTK/TransferElement.h>
+
+#include <doocs/EqCall.h>
+
+#include <boost/shared_ptr.hpp>
+
+#include <chrono>
+#include <map>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace ChimeraTK {
+
+  class DoocsBackend;
+
+  /**
+   * Low-level transfer element performing the RPC transfers of a complete DOOCS property. It is used by accessors which
+   * may access only a part of a property (the fields of IFFF and USTR properties and slices of arrays). Accessors of the same
+   * property share one instance when they are put into the same TransferGroup (see mayReplaceOther()), so the group
+   * performs a single eq.get() resp. eq.set() for the property. The accessors decorate the raw element: they take their
+   * part from dst after a read and put their part into src before a write.
+   *
+   * The property is divided into "units" (the fields of an IFFF or USTR property resp. the array elements). Each accessor
+   * registers the units it covers with addCoverage(). Since accessors sharing a raw element can only be written
+   * together through their TransferGroup, src is completely overwritten by the accessors if all units are covered.
+   * Otherwise the current value of the property is obtained in doPreWrite() before the accessors modify their units
+   * (read-modify-write).
+   */
+  class DoocsBackendRawPropertyTransferElement : public TransferElement {
+   public:
+    DoocsBackendRawPropertyTransferElement(boost::shared_ptr<DoocsBackend> backend, const std::string& path,
+        int doocsTypeId, size_t length, size_t nUnits);
+
+    /// data received by the last read transfer
+    doocs::EqData dst;
+
+    /// data to be sent by the next write transfer, filled by the accessors in doPreWrite()
+    doocs::EqData src;
+
+    /// Register units [begin, end) as written by an accessor using this element
+    void addCoverage(size_t begin, size_t end);
+
+    const std::string& getPath() const { return _path; }
+
+    /// Override the RPC timeout of the backend (see DoocsBackendRegisterAccessorBase::setRpcTimeout())
+    void setRpcTimeout(std::chrono::milliseconds timeout) { _rpcTimeout = timeout; }
+
+    void doReadTransferSynchronously() override;
+
+    void doPreWrite(TransferType type, VersionNumber versionNumber) override;
+
+    bool doWriteTransfer(VersionNumber versionNumber) override;
+
+    bool isReadOnly() const override { return false; }
+
+    bool isReadable() const override { return true; }
+
+    bool isWriteable() const override { return _isWriteable; }
+
+    const std::type_info& getValueType() const override { return typeid(void); }
+
+    bool mayReplaceOther(const boost::shared_ptr<TransferElement const>& other) const override;
+
+    std::vector<boost::shared_ptr<TransferElement>> getHardwareAccessingElements() override {
+      return {boost::enable_shared_from_this<TransferElement>::shared_from_this()};
+    }
+
+    std::list<boost::shared_ptr<TransferElement>> getInternalElements() override { return {}; }
+
+    void replaceTransferElement(boost::shared_ptr<TransferElement>) override {}
+
+    boost::shared_ptr<TransferElement> makeCopyRegisterDecorator() override {
+      throw ChimeraTK::logic_error("DoocsBackendRawPropertyTransferElement::makeCopyRegisterDecorator() is not "
+                                   "implemented"); // LCOV_EXCL_LINE (internal element only)
+    }
+
+   private:
+    /// Obtain the current value of the property into dst, from the snapshot cache if possible
+    void readForModify();
+
+    /// Set src to the data type of the property without content
+    void resetWriteBuffer();
+
+    /// Whether the property is a structure with fixed layout (IFFF, USTR), whose length must not be adjusted
+    bool hasStructType() const { return _doocsTypeId == DATA_IFFF || _doocsTypeId == DATA_USTR; }
+
+    boost::shared_ptr<DoocsBackend> _backend;
+    std::string _path;
+    int _doocsTypeId;
+    size_t _length;
+
+    /// Effective timeout for the RPC calls
+    std::chrono::milliseconds getRpcTimeout() const;
+
+    doocs::EqAdr _ea;
+    DoocsBackendTimedRpc _eq;
+    std::optional<std::chrono::milliseconds> _rpcTimeout;
+
+    /// number of units of the property
+    size_t _nUnits;
+
+    /// units written by the accessors using this element, as disjoint and non-adjacent ranges [begin, end) keyed by
+    /// begin
+    std::map<size_t, size_t> _covered;
+
+    /// Whether all units are written by the accessors
+    bool isFullyCovered() const {
+      return _covered.size() == 1 && _covered.begin()->first == 0 && _covered.begin()->second == _nUnits;
+    }
+
+    bool _isWriteable{true};
+  };
+
+} // namespace ChimeraTK
@@ -3,11 +3,15 @@
 #pragma once
 
 #include "DoocsBackend.h"
+#include "DoocsBackendChangeFilter.h"
+#include "DoocsBackendEqDataPool.h"
+#include "DoocsBackendLatencyTracing.h"
+#include "DoocsBackendRawPropertyTransferElement.h"
+#include "DoocsBackendTimedRpc.h"
 #include "RegisterInfo.h"
 #include "ZMQSubscriptionManager.h"
 
 #include <ChimeraTK/AccessMode.h>
-#include <ChimeraTK/async/DataConsistencyKey.h>
 #include <ChimeraTK/Exception.h>
 #include <ChimeraTK/MappedImage.h>
 #include <ChimeraTK/NDRegisterAccessor.h>
@@ -17,23 +21,71 @@
 
 #include <eq_errors.h>
 
+#include <boost/make_shared.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <typeinfo>
+
 namespace ChimeraTK {
 
+  /**
+   * Update as pushed into the notification queue of an accessor, with the time stamps for the latency tracing. The data
+   * is held in a buffer of the accessor's DoocsBackendEqDataPool.
+   */
+  struct DoocsBackendNotification {
+    DoocsBackendEqDataPool::Handle data;
+    NotificationTrace trace;
+
+    /// data converted into the user type, see DoocsBackendRegisterAccessorBase::convertOnReceive
+    std::shared_ptr<void> converted{};
+  };
+
+  /********************************************************************************************************************/
+
+  class DoocsBackendEventBundle;
+
   /** This is the untemplated base class which unifies all data members not depending on the UserType. */
   class DoocsBackendRegisterAccessorBase {
    public:
+    virtual ~DoocsBackendRegisterAccessorBase() = default;
+
     /// register path
     std::string _path;
 
-    /// DOOCS address structure
-    doocs::EqAdr ea;
-
-    /// DOOCS rpc call object
-    doocs::EqCall eq;
+    /// DOOCS address structure and rpc call object
+    struct RpcContext {
+      explicit RpcContext(const std::string& address) : eq(address) {}
+      doocs::EqAdr ea;
+      DoocsBackendTimedRpc eq;
+    };
+
+    /// Obtain the RpcContext, which is created on first use. Accessors using only ZeroMQ never create it.
+    RpcContext& rpc() {
+      if(!_rpc) {
+        _rpc = std::make_unique<RpcContext>(_path);
+        _rpc->ea = _backend->_addressCache.get(_path);
+      }
+      return *_rpc;
+    }
 
-    /// DOOCS data structures
+    /// DOOCS data structures. The array of src is allocated on the first write only (see prepareWriteBuffer()).
     doocs::EqData src, dst;
 
+    /// number of elements of the DOOCS data (body length for images), 0 if the length is not set explicitly
+    size_t doocsLength{0};
+
+    /// Set the timeout for the RPC calls of this accessor, overriding the timeout of the backend (CDD parameter
+    /// rpcTimeoutMs). A timeout of 0 disables the timeout. See DoocsBackendTimedRpc.
+    void setRpcTimeout(std::chrono::milliseconds timeout) {
+      _rpcTimeout = timeout;
+      if(_rawElement) _rawElement->setRpcTimeout(timeout);
+    }
+
+    /// Effective timeout for the RPC calls of this accessor
+    std::chrono::milliseconds getRpcTimeout() const { return _rpcTimeout.value_or(_backend->_rpcTimeout); }
+
     /// flag if the DOOCS data type is an array or not
     bool isArray{false};
 
@@ -46,15 +98,100 @@ namespace ChimeraTK {
     /// flag if the accessor should affect only a part of the property (in case of an array)
     bool isPartial{false};
 
-    /// flag if a ZeroMQ subscribtion is used for reading data (c.f. AccessMode::wait_for_new_data)
+    /// flag if a ZeroMQ subscribtion is used for reading data (c.f. AccessMode::wait_for_new_data). Also set if the
+    /// data is polled by the DoocsBackendPollScheduler instead (see usePolling), since the data is received through the
+    /// notifications queue in the same way.
     bool useZMQ{false};
 
+    /// flag if the property is polled by the DoocsBackendPollScheduler, since it has no ZeroMQ publisher
+    bool usePolling{false};
+
     /// flag whether it should receive updates from the ZeroMQ subscription. Is used by the ZMQSubscriptionManager and
-    /// access requires a lock on the corresponding listeners_mutex.
-    bool isActiveZMQ{false};
+    /// changes require a lock on the corresponding listeners_mutex. It is atomic since the DoocsBackendEventBundle
+    /// reads it under the lock of another subscription.
+    std::atomic<bool> isActiveZMQ{false};
 
     /// future_queue used to notify the TransferFuture about completed transfers
-    cppext::future_queue<doocs::EqData> notifications;
+    cppext::future_queue<DoocsBackendNotification> notifications;
+
+    /// buffers for the data pushed into the notifications queue, only used with ZeroMQ. Shared by all accessors of the
+    /// same ZeroMQ subscription, see ZMQSubscriptionManager::Subscription::pool.
+    std::shared_ptr<DoocsBackendEqDataPool> _eqDataPool;
+
+    /**
+     * Drop updates received with AccessMode::wait_for_new_data (through ZeroMQ or polling) which are equal to the
+     * previous update, see DoocsBackendChangeFilter. Floating point values are considered equal within the given
+     * tolerance. Calling the function again changes the tolerance. The filters must not be used for accessors of a
+     * DoocsBackendEventBundle, since dropped updates would never complete the bundle.
+     */
+    void enableChangeFilter(double tolerance = 0.) { setDeadband(tolerance); }
+
+    /// Drop updates whose numeric values differ from the previous update by at most the absolute deadband, or by at
+    /// most the relative deadband times the previous value (see enableChangeFilter())
+    void setDeadband(double absolute, double relative = 0.) { changeFilter().setDeadband({absolute, relative}); }
+
+    /// Deliver only every Nth update received with AccessMode::wait_for_new_data, and no more than one update per
+    /// minInterval. Can be combined with the deadband, dropped updates then count for the next one.
+    void setDecimation(size_t everyNth, std::chrono::milliseconds minInterval = {}) {
+      changeFilter().setDecimation(everyNth, minInterval);
+    }
+
+    /// Number of updates dropped by the change filter
+    size_t getSuppressedUpdateCount() const {
+      auto* filter = _changeFilter.load(std::memory_order_acquire);
+      return filter ? filter->getSuppressedCount() : 0;
+    }
+
+    /// Change filter used when pushing updates, nullptr if not enabled. Atomic since it can be enabled while updates
+    /// are pushed. Once enabled, it is not replaced.
+    std::atomic<DoocsBackendChangeFilter*> _changeFilter{nullptr};
+
+    /// Check the change filter, if enabled. Returns false if the update shall be dropped.
+    bool passesChangeFilter(const doocs::EqData& data) {
+      auto* filter = _changeFilter.load(std::memory_order_acquire);
+      if(!filter || filter->accept(data)) return true;
+      _backend->_statistics.recordSuppressedUpdate();
+      return false;
+    }
+
+    /// Let the next update pass the change filter (called on activation, so the initial value is always pushed)
+    void resetChangeFilter() {
+      if(auto* filter = _changeFilter.load(std::memory_order_acquire)) filter->reset();
+    }
+
+    /**
+     * Conversion on the receive side (CDD parameter convertOnReceive): the ZeroMQ callback (resp. the decoding worker)
+     * converts the received data into a buffer of the UserType, which is passed with the notification, so
+     * doPostRead() only needs to swap it with the application buffer. Accessors with the same conversionKey (same
+     * accessor type, UserType and slice of the same property) share the converted buffer, so the conversion is done
+     * once per update for all of them.
+     *
+     * Enabled by the accessor implementation at the end of its constructor. The key must not be changed afterwards.
+     */
+    std::atomic<bool> convertOnReceive{false};
+
+    struct ConversionKey {
+      const std::type_info* accessorType{nullptr};
+      size_t elementOffset{0};
+      size_t nElements{0};
+
+      bool operator==(const ConversionKey& other) const {
+        return *accessorType == *other.accessorType && elementOffset == other.elementOffset &&
+            nElements == other.nElements;
+      }
+    };
+    ConversionKey conversionKey;
+
+    /// Convert the received data into a new buffer of the UserType (see convertOnReceive). Returns nullptr if the data
+    /// cannot be converted (e.g. wrong length), doPostRead() then converts the data as usual and reports the error.
+    /// Must not throw.
+    virtual std::shared_ptr<void> convertReceived(const doocs::EqData&) noexcept { return nullptr; }
+
+    /// bundle aligning the ZeroMQ updates with other accessors by eventId, if any (see DoocsBackendEventBundle)
+    std::shared_ptr<DoocsBackendEventBundle> _bundle;
+
+    /// Remove the accessor from its bundle, if any. Must be called after unsubscribing.
+    void leaveBundle();
 
     /// Flag whether shutdown() has been called or not
     bool shutdownCalled{false};
@@ -62,9 +199,59 @@ namespace ChimeraTK {
     /// Pointer to the backend
     boost::shared_ptr<DoocsBackend> _backend;
 
+    /// Registration of _path in the address cache of the backend, obtained once the accessor has been constructed
+    DoocsBackendAddressCache::Registration _addressRegistration;
+
+    /// Low-level transfer element for the whole property, if used by the accessor (see useRawElement()). It is shared
+    /// with other accessors of the same property within a TransferGroup.
+    boost::shared_ptr<DoocsBackendRawPropertyTransferElement> _rawElement;
+
+    /// Data of the last read: dst, or the buffer of the raw element if used for reading
+    doocs::EqData& readBuffer() { return _rawElement && !useZMQ ? _rawElement->dst : dst; }
+
+    /// Data for the next write: src, or the buffer of the raw element if used
+    doocs::EqData& writeBuffer() { return _rawElement ? _rawElement->src : src; }
+
    protected:
+    std::unique_ptr<RpcContext> _rpc;
+
+    /// owner of the change filter, see enableChangeFilter()
+    std::unique_ptr<DoocsBackendChangeFilter> _changeFilterStorage;
+
+    /// Obtain the change filter, which is created on first use
+    DoocsBackendChangeFilter& changeFilter() {
+      if(!useZMQ) {
+        throw ChimeraTK::logic_error("DoocsBackend: update filters require AccessMode::wait_for_new_data: " + _path);
+      }
+      if(!_changeFilterStorage) {
+        _changeFilterStorage = std::make_unique<DoocsBackendChangeFilter>();
+        _changeFilter.store(_changeFilterStorage.get(), std::memory_order_release);
+      }
+      return *_changeFilterStorage;
+    }
+
+    /// timeout set with setRpcTimeout()
+    std::optional<std::chrono::milliseconds> _rpcTimeout;
+
+    /// Allocate the array of src with the length of the property, if not yet done
+    void prepareWriteBuffer() {
+      if(_srcPrepared) return;
+      if(doocsLength > 0) src.length(int(doocsLength));
+      _srcPrepared = true;
+    }
+    bool _srcPrepared{false};
+
     /// first valid eventId
     doocs::EventId _lastEventId;
+
+    /// latency tracing channel of this accessor, nullptr if tracing is disabled or ZeroMQ is not used
+    std::shared_ptr<LatencyTracer::Channel> _latencyChannel;
+
+    /// trace of the update currently being read from the notification queue
+    NotificationTrace _currentTrace;
+
+    /// converted data of the update currently being read from the notification queue, see convertOnReceive
+    std::shared_ptr<void> _currentConverted;
   };
 
   /********************************************************************************************************************/
@@ -80,32 +267,59 @@ namespace ChimeraTK {
      * exception.
      */
     void shutdown() {
-      if(useZMQ) {
+      if(usePolling) {
+        _backend->_pollScheduler->remove(this);
+      }
+      else if(useZMQ) {
         DoocsBackendNamespace::ZMQSubscriptionManager::getInstance().unsubscribe(_path, this);
+        leaveBundle();
       }
       shutdownCalled = true;
     }
 
     void doReadTransferSynchronously() override;
 
-    bool doWriteTransfer(VersionNumber) override {
-      write_internal();
-      return false;
+    bool doWriteTransfer(VersionNumber version) override {
+      if(_rawElement) return _rawElement->writeTransfer(version);
+      return write_internal();
     }
 
-    void doPreRead(TransferType) override {
+    void doPreRead(TransferType type) override {
       if(!_backend->isOpen()) throw ChimeraTK::logic_error("Read operation not allowed while device is closed.");
       if(!isReadable()) throw ChimeraTK::logic_error("Try to read from write-only register \"" + _path + "\".");
+      if(_rawElement && !useZMQ) _rawElement->preRead(type);
     }
 
-    void doPreWrite(TransferType, VersionNumber) override {
+    void doPreWrite(TransferType type, VersionNumber version) override {
       if(!_backend->isOpen()) throw ChimeraTK::logic_error("Write operation not allowed while device is closed.");
+      // a previous asynchronous write has been rejected because the property is read-only (see DoocsBackendAsyncWriter)
+      if(_backend->_asyncWriter && _isWriteable && _backend->_addressCache.isReadOnly(_path)) _isWriteable = false;
       if(!isWriteable()) throw ChimeraTK::logic_error("Try to write read-only register \"" + _path + "\".");
+      if(_rawElement) {
+        _rawElement->preWrite(type, version);
+      }
+      else {
+        prepareWriteBuffer();
+      }
+    }
+
+    void doPostWrite(TransferType type, VersionNumber version) override {
+      if(_rawElement) _rawElement->postWrite(type, version);
     }
 
-    void doPostRead(TransferType, bool hasNewData) override {
+    void doPostRead(TransferType type, bool hasNewData) override {
+      // rethrows exceptions of the raw element's transfer
+      if(_rawElement && !useZMQ) _rawElement->postRead(type, hasNewData);
+
       if(!hasNewData) return;
 
+      auto& data = readBuffer();
+
+      if(_latencyChannel && _currentTrace.isValid()) {
+        _latencyChannel->record(_currentTrace, std::chrono::steady_clock::now());
+        _currentTrace = {};
+      }
+
       // Note: the original idea was to extract the time stamp from the received data. This idea has been dropped since
       // the time stamp attached to the data seems to be unreliably, at least for the x2timer macro pulse number. If the
       // unreliable time stamp is attached to the trigger, all data will get this time stamp. This leads to error
@@ -113,19 +327,19 @@ namespace ChimeraTK {
       // our own time stamp here.
 
       // See spec. B.1.3.4.2
-      TransferElement::setDataValidity(dst.error() == 0 ? DataValidity::ok : DataValidity::faulty);
+      TransferElement::setDataValidity(data.error() == 0 ? DataValidity::ok : DataValidity::faulty);
 
       // If the eventid is valid (!= 0) but older than the last one, we have backward running eventids but VersionNumber
       // must not run backwards. Keep VersionNumber unchanged and return. See spec B.1.3.2. (Note: after a re-connection
       // to a slow variable the version number might be the same)
-      if(dst.get_event_id() != doocs::EventId(0) && dst.get_event_id() < _lastEventId) {
+      if(data.get_event_id() != doocs::EventId(0) && data.get_event_id() < _lastEventId) {
         return;
       }
 
-      if(dst.get_event_id() == doocs::EventId()) {
+      if(data.get_event_id() == doocs::EventId()) {
         // See spec. B.1.3.4.1
         TransferElement::_versionNumber = {};
-        _lastEventId = dst.get_event_id();
+        _lastEventId = data.get_event_id();
         return;
       }
 
@@ -136,10 +350,10 @@ namespace ChimeraTK {
       //
       // During startup, we can receive multiple receives with event_id == 0. The first check ensures that
       // we do not hand out the VersionNumber{nullptr} then
-      // if(_lastEventId == doocs::EventId() || _lastEventId != dst.get_event_id()) {
+      // if(_lastEventId == doocs::EventId() || _lastEventId != data.get_event_id()) {
       // Get VersionNumber from the EventIdMapper. See spec B.1.3.3.
-      auto newVersionNumber =
-          _backend->_dataConsistencyRealm->getVersion(async::DataConsistencyKey(dst.get_event_id().to_int()));
+      // Accessors receiving the same eventId share the lookup through the backend's cache.
+      auto newVersionNumber = _backend->_versionCache->getVersion(data.get_event_id());
 
       // Minimum version is _backend->_startVersion. See spec. B.1.3.3.1.
       auto startVersion = _backend->getStartVersion();
@@ -157,14 +371,14 @@ namespace ChimeraTK {
 
       // See spec. B.1.3.4.1
       TransferElement::_versionNumber = newVersionNumber;
-      _lastEventId = dst.get_event_id();
+      _lastEventId = data.get_event_id();
     }
 
     bool isReadOnly() const override { return isReadable() && not isWriteable(); }
 
     bool isReadable() const override { return _isReadable; }
 
-    bool isWriteable() const override { return _isWriteable; }
+    bool isWriteable() const override { return _isWriteable && (!_rawElement || _rawElement->isWriteable()); }
 
     using TransferElement::_readQueue;
 
@@ -179,12 +393,27 @@ namespace ChimeraTK {
     }
 
     std::vector<boost::shared_ptr<TransferElement>> getHardwareAccessingElements() override {
+      createRawElement();
+      if(_rawElement) return _rawElement->getHardwareAccessingElements();
       return {boost::enable_shared_from_this<TransferElement>::shared_from_this()};
     }
 
-    std::list<boost::shared_ptr<ChimeraTK::TransferElement>> getInternalElements() override { return {}; }
+    std::list<boost::shared_ptr<ChimeraTK::TransferElement>> getInternalElements() override {
+      createRawElement();
+      if(_rawElement) return {_rawElement};
+      return {};
+    }
 
-    void replaceTransferElement(boost::shared_ptr<TransferElement> /*newElement*/) override {} // LCOV_EXCL_LINE
+    void replaceTransferElement(boost::shared_ptr<TransferElement> newElement) override {
+      createRawElement();
+      if(!_rawElement) return;
+      // share the raw element with other accessors of the same property
+      auto casted = boost::dynamic_pointer_cast<DoocsBackendRawPropertyTransferElement>(newElement);
+      if(casted && casted->mayReplaceOther(_rawElement)) {
+        casted->addCoverage(_coveredUnits.first, _coveredUnits.second);
+        _rawElement = casted;
+      }
+    }
 
     void interrupt() override {
       if(this->getAccessModeFlags().has(AccessMode::wait_for_new_data)) {
@@ -196,8 +425,31 @@ namespace ChimeraTK {
     DoocsBackendRegisterAccessor(boost::shared_ptr<DoocsBackend> backend, const std::string& path,
         const std::string& registerPathName, size_t numberOfWords, size_t wordOffsetInRegister, AccessModeFlags flags);
 
-    /// internal write from doocs::EqData src
-    void write_internal();
+    /// internal write from doocs::EqData src. Returns true if a previously written value has been lost (only possible
+    /// in the asynchronous write mode, see DoocsBackendAsyncWriter).
+    bool write_internal();
+
+    /// Obtain the current value of the property into dst for a read-modify-write. A recent snapshot from the backend
+    /// is used if available (see DoocsBackendSnapshotCache), otherwise the property is read from the server.
+    void readForModify();
+
+    /**
+     * Allow the transfers through a DoocsBackendRawPropertyTransferElement for the whole property, which covers
+     * units [firstUnit, endUnit) of nUnits. Must be called at the end of the constructor, after initialise(). The raw
+     * element is only created by createRawElement() once it is needed, i.e. when the accessor is put into a
+     * TransferGroup, so accessors used on their own perform their transfers directly. If the accessor uses ZeroMQ, the
+     * raw element is used for writing only.
+     */
+    void useRawElement(size_t nUnits, size_t firstUnit, size_t endUnit);
+
+    /// Create the raw element if allowed by useRawElement() and not yet done
+    void createRawElement();
+
+    /// number of units of the raw element, 0 if no raw element may be used
+    size_t _nRawUnits{0};
+
+    /// units of the raw element covered by this accessor
+    std::pair<size_t, size_t> _coveredUnits;
 
     /**
      *  Perform initialisation (i.e. connect to server etc.).
@@ -226,8 +478,13 @@ namespace ChimeraTK {
     // from catalogue (-> cache)
     int rc = 1;
     if(_backend->isOpen()) {
+      // use temporary call objects, so accessors using ZeroMQ do not keep an RpcContext. A timeout is treated like an
+      // unreachable server.
+      auto ea = _backend->_addressCache.get(_path);
+      DoocsBackendTimedRpc eq(_path);
       doocs::EqData tmp;
-      rc = eq.get(&ea, &tmp, &dst);
+      rc = eq.get(&ea, &tmp, &dst, _backend->_rpcTimeout);
+      if(!rc) _backend->_addressCache.update(_path, ea);
     }
     if(rc) {
       if(rc == eq_errors::ill_property || rc == eq_errors::ill_location || rc == eq_errors::ill_address) {
@@ -287,20 +544,31 @@ namespace ChimeraTK {
     NDRegisterAccessor<UserType>::buffer_2D.resize(1);
     NDRegisterAccessor<UserType>::buffer_2D[0].resize(nElements);
 
-    // set proper type information in the source doocs::EqData
+    // set proper type information in the source doocs::EqData. The length is set only before the first write, so
+    // read-only accessors do not allocate the array.
     src.set_type(typeId);
     if(typeId == DATA_IMAGE) {
       // DOOCS data structure has its own image header format and length() is only used for body length
-      src.length(actualLength - sizeof(ChimeraTK::ImgHeader));
+      doocsLength = actualLength - sizeof(ChimeraTK::ImgHeader);
     }
     else if(typeId != DATA_IIII) {
-      src.length(actualLength);
+      doocsLength = actualLength;
     }
 
     // use ZeroMQ with AccessMode::wait_for_new_data
     if(useZMQ) {
-      // subscribe via subscription manager
-      DoocsBackendNamespace::ZMQSubscriptionManager::getInstance().subscribe(_path, this);
+      if(usePolling) {
+        // One buffer per slot of the notification queue (including the one being written) and one being filled by
+        // the poll scheduler. The buffers are allocated with the first updates.
+        auto* statistics = &_backend->_statistics;
+        _eqDataPool = DoocsBackendEqDataPool::create(notifications.size() + 2, typeId, doocsLength,
+            [statistics] { statistics->recordZmqBufferAllocation(); });
+        _backend->_pollScheduler->add(this);
+      }
+      else {
+        // subscribe via subscription manager, which sets the _eqDataPool shared by the accessors of the subscription
+        DoocsBackendNamespace::ZMQSubscriptionManager::getInstance().subscribe(_path, this);
+      }
     }
   }
 
@@ -321,25 +589,39 @@ namespace ChimeraTK {
       // check for unknown access mode flags
       flags.checkForUnknownFlags({AccessMode::wait_for_new_data});
 
-      // set address
-      ea.adr(path);
-
       // obtain catalogue entry
-      auto info = backend->getBackendRegisterCatalogue().getBackendRegister(registerPathName);
+      auto info = backend->getBackendRegisterCatalogue()->getBackendRegister(registerPathName);
 
       // use zero mq subscriptiopn?
       if(flags.has(AccessMode::wait_for_new_data)) {
         if(!info.getSupportedAccessModes().has(AccessMode::wait_for_new_data)) {
-          throw ChimeraTK::logic_error("invalid access mode for this register");
+          // properties without ZeroMQ can be polled by the backend, if enabled
+          if(!backend->_pollScheduler || !info.isReadable()) {
+            throw ChimeraTK::logic_error("invalid access mode for this register");
+          }
+          usePolling = true;
         }
         useZMQ = true;
 
         // Create notification queue.
-        notifications = cppext::future_queue<doocs::EqData>(3);
-        _readQueue = notifications.then<void>([this](doocs::EqData& data) { this->dst = data; }, std::launch::deferred);
+        notifications = cppext::future_queue<DoocsBackendNotification>(3);
+        _readQueue = notifications.then<void>(
+            [this](DoocsBackendNotification& notification) {
+              // Swap instead of copy, so the buffer returns to the pool with the previous content of dst. This avoids
+              // allocations in steady state.
+              std::swap(this->dst, *notification.data);
+              notification.data.reset();
+              this->_currentTrace = notification.trace;
+              this->_currentConverted = std::move(notification.converted);
+            },
+            std::launch::deferred);
+        _latencyChannel = backend->_latencyTracer.createChannel(path);
       }
 
       initialise(info);
+
+      // only now the address is known to be valid, so open() can connect to its location
+      _addressRegistration = backend->_addressCache.registerAddress(path);
     }
     catch(...) {
       this->shutdown();
@@ -349,6 +631,28 @@ namespace ChimeraTK {
 
   /********************************************************************************************************************/
 
+  template<typename UserType>
+  void DoocsBackendRegisterAccessor<UserType>::useRawElement(size_t nUnits, size_t firstUnit, size_t endUnit) {
+    _nRawUnits = nUnits;
+    _coveredUnits = {firstUnit, endUnit};
+  }
+
+  /********************************************************************************************************************/
+
+  template<typename UserType>
+  void DoocsBackendRegisterAccessor<UserType>::createRawElement() {
+    if(_rawElement || _nRawUnits == 0) return;
+    _rawElement =
+        boost::make_shared<DoocsBackendRawPropertyTransferElement>(_backend, _path, src.type(), doocsLength, _nRawUnits);
+    _rawElement->setExceptionBackend(_backend);
+    if(_rpcTimeout) _rawElement->setRpcTimeout(*_rpcTimeout);
+    _rawElement->addCoverage(_coveredUnits.first, _coveredUnits.second);
+    // reads now go to the raw element, release the data of previous reads (unless used for the ZeroMQ updates)
+    if(!useZMQ) dst = doocs::EqData();
+  }
+
+  /********************************************************************************************************************/
+
   template<typename UserType>
   DoocsBackendRegisterAccessor<UserType>::~DoocsBackendRegisterAccessor() {
     assert(shutdownCalled);
@@ -358,40 +662,87 @@ namespace ChimeraTK {
 
   template<typename UserType>
   void DoocsBackendRegisterAccessor<UserType>::doReadTransferSynchronously() {
+    if(_rawElement) {
+      _rawElement->readTransfer();
+      return;
+    }
+
     _backend->checkActiveException();
 
     assert(!useZMQ);
 
     boost::this_thread::interruption_point();
 
+    // make sure we read back values written asynchronously before (this includes the read of a read-modify-write)
+    if(_backend->_asyncWriter) {
+      _backend->_asyncWriter->flush(_path);
+    }
+
     // read data
     doocs::EqData tmp;
-    int rc = eq.get(&ea, &tmp, &dst);
+    auto start = std::chrono::steady_clock::now();
+    auto& ctx = rpc();
+    int rc = ctx.eq.get(&ctx.ea, &tmp, &dst, getRpcTimeout());
+    bool failed = rc == doocs::TransactionResult::transaction_error || rc == doocs::TransactionResult::transport_error;
+    _backend->_statistics.recordRead(std::chrono::steady_clock::now() - start, !failed);
+    if(ctx.eq.hasTimedOut()) _backend->_statistics.recordTimeout();
 
     // check error
-    if(rc == doocs::TransactionResult::transaction_error || rc == doocs::TransactionResult::transport_error) {
+    if(failed) {
       _backend->informRuntimeError(_path);
-      throw ChimeraTK::runtime_error(std::string("Cannot read from DOOCS property: ") + dst.get_string());
+      throw ChimeraTK::runtime_error(std::string("Cannot read from DOOCS property: ") + ctx.eq.getErrorMessage(dst));
+    }
+    if(dst.error() == 0) {
+      _backend->_snapshotCache.update(_path, dst, DoocsBackendSnapshotCache::Source::read);
     }
   }
 
   /********************************************************************************************************************/
 
   template<typename UserType>
-  void DoocsBackendRegisterAccessor<UserType>::write_internal() {
+  void DoocsBackendRegisterAccessor<UserType>::readForModify() {
+    if(_backend->_snapshotCache.get(_path, dst)) {
+      return;
+    }
+    doReadTransferSynchronously();
+  }
+
+  /********************************************************************************************************************/
+
+  template<typename UserType>
+  bool DoocsBackendRegisterAccessor<UserType>::write_internal() {
     _backend->checkActiveException();
 
+    if(_backend->_asyncWriter) {
+      // the queued value is the most recent one, also for read-modify-writes before it has been sent
+      _backend->_snapshotCache.update(_path, src, DoocsBackendSnapshotCache::Source::write);
+      return _backend->_asyncWriter->enqueue(_path, src);
+    }
+
     // write data
-    int rc = eq.set(&ea, &src, &dst);
+    _backend->_snapshotCache.beginWrite(_path);
+    auto start = std::chrono::steady_clock::now();
+    auto& ctx = rpc();
+    int rc = ctx.eq.set(&ctx.ea, &src, &dst, getRpcTimeout());
+    bool readOnly = !ctx.eq.hasTimedOut() && dst.error() == eq_errors::read_only;
+    bool failed =
+        rc == doocs::TransactionResult::transaction_error || rc == doocs::TransactionResult::transport_error || readOnly;
+    _backend->_statistics.recordWrite(std::chrono::steady_clock::now() - start, !failed);
+    if(ctx.eq.hasTimedOut()) _backend->_statistics.recordTimeout();
     // check error
-    if(rc == doocs::TransactionResult::transaction_error || rc == doocs::TransactionResult::transport_error ||
-        (dst.error() == eq_errors::read_only)) {
+    if(failed) {
+      _backend->_snapshotCache.endWrite(_path, false);
       _backend->informRuntimeError(_path);
-      if(dst.error() == eq_errors::read_only) {
+      // the content of src is still in use by the abandoned call, allocate it again before the next write
+      if(ctx.eq.hasTimedOut()) _srcPrepared = false;
+      if(readOnly) {
         this->_isWriteable = false;
       }
-      throw ChimeraTK::runtime_error(std::string("Cannot write to DOOCS property: ") + dst.get_string());
+      throw ChimeraTK::runtime_error(std::string("Cannot write to DOOCS property: ") + ctx.eq.getErrorMessage(dst));
     }
+    _backend->_snapshotCache.update(_path, src, DoocsBackendSnapshotCache::Source::write);
+    _backend->_snapshotCache.endWrite(_path, true);
+    return false;
   }
 
   /********************************************************************************************************************/
@@ -0,0 +1,144 @@
+// SPDX-FileCopyrightText: Deutsches Elektronen-Synchrotron DESY, MSK, ChimeraTK Project <chimeratk-support@desy.de>
+// SPDX-License-Identifier: LGPL-3.0-or-later
+#pragma once
+
+#include <doocs/EqCall.h>
+
+#include <chrono>
+#include <map>
+#include <mutex>
+#include <string>
+
+namespace ChimeraTK {
+
+  /**
+   * Recent values of DOOCS properties, used to avoid the read round trip of a read-modify-write (partial array
+   * accesses, IIII elements, IFFF fields). The snapshots are taken from successful RPC reads, ZeroMQ updates and values
+   * written by the backend itself. A snapshot is only used while it is younger than the configured maximum age (CDD
+   * parameter rmwMaxAge in milliseconds). With a maximum age of 0 (the default) the cache is disabled and every
+   * read-modify-write reads the property from the server first.
+   *
+   * Note that changes made by other clients within the maximum age are overwritten by a read-modify-write based on a
+   * snapshot, so the maximum age should be chosen according to how the property is used.
+   *
+   * Updates received through a subscription (ZeroMQ, polling) are not ordered with respect to the backend's own
+   * writes: an update carrying the value from before a write may arrive after the write has completed. Hence such
+   * updates never replace the snapshot of a write, which is replaced only by the next write or RPC read, or expires
+   * with the maximum age. While a write to the property is in flight (see beginWrite()), only the written value is
+   * stored.
+   */
+  class DoocsBackendSnapshotCache {
+   public:
+    explicit DoocsBackendSnapshotCache(std::chrono::milliseconds maxAge = {}) : _maxAge(maxAge) {}
+
+    bool isEnabled() const { return _maxAge.count() > 0; }
+
+    /// Origin of the data passed to update()
+    enum class Source {
+      read,        ///< synchronous RPC read
+      write,       ///< value written by the backend itself
+      subscription ///< ZeroMQ update or value polled in the background
+    };
+
+    /// Store the given data as the current value of the property with the given address. Data not written by the
+    /// backend itself is ignored while a write is in flight, data from a subscription also while the current snapshot
+    /// stems from a write which has not yet expired.
+    void update(const std::string& address, const doocs::EqData& data, Source source) {
+      if(!isEnabled()) return;
+      std::lock_guard<std::mutex> lk(_mx);
+      auto now = std::chrono::steady_clock::now();
+      auto& entry = _snapshots[address];
+      if(source != Source::write && entry.writesInFlight > 0) return;
+      if(source == Source::subscription && entry.valid && entry.fromWrite && now - entry.time <= _maxAge) return;
+      entry.data = data;
+      entry.time = now;
+      entry.fromWrite = source == Source::write;
+      entry.valid = true;
+    }
+
+    /// Mark a write to the given address as in flight, until the matching endWrite()
+    void beginWrite(const std::string& address) {
+      if(!isEnabled()) return;
+      std::lock_guard<std::mutex> lk(_mx);
+      ++_snapshots[address].writesInFlight;
+    }
+
+    /// Complete a write started with beginWrite(). The written data must have been passed to update() before, if the
+    /// write has succeeded. Otherwise the snapshot is removed, since the value on the server is unknown.
+    void endWrite(const std::string& address, bool success) {
+      if(!isEnabled()) return;
+      std::lock_guard<std::mutex> lk(_mx);
+      auto& entry = _snapshots[address];
+      if(entry.writesInFlight > 0) --entry.writesInFlight;
+      if(!success) {
+        entry.valid = false;
+        entry.data = doocs::EqData();
+      }
+    }
+
+    /// Copy the snapshot of the given address into data, if there is a snapshot younger than the maximum age. Returns
+    /// whether a snapshot has been copied.
+    bool get(const std::string& address, doocs::EqData& data) const {
+      if(!isEnabled()) return false;
+      std::lock_guard<std::mutex> lk(_mx);
+      auto it = _snapshots.find(address);
+      if(it == _snapshots.end() || !it->second.valid || std::chrono::steady_clock::now() - it->second.time > _maxAge) {
+        return false;
+      }
+      data = it->second.data;
+      return true;
+    }
+
+    /// Remove the snapshot of the given address
+    void invalidate(const std::string& address) {
+      if(!isEnabled()) return;
+      std::lock_guard<std::mutex> lk(_mx);
+      auto it = _snapshots.find(address);
+      if(it == _snapshots.end()) return;
+      if(it->second.writesInFlight > 0) {
+        // keep the entry, so endWrite() finds the counter
+        it->second.valid = false;
+        it->second.data = doocs::EqData();
+        return;
+      }
+      _snapshots.erase(it);
+    }
+
+    /// Remove all snapshots, e.g. when the backend is closed or goes into the exception state. Writes in flight stay
+    /// registered.
+    void clear() {
+      if(!isEnabled()) return;
+      std::lock_guard<std::mutex> lk(_mx);
+      for(auto it = _snapshots.begin(); it != _snapshots.end();) {
+        if(it->second.writesInFlight > 0) {
+          it->second.valid = false;
+          it->second.data = doocs::EqData();
+          ++it;
+        }
+        else {
+          it = _snapshots.erase(it);
+        }
+      }
+    }
+
+   private:
+    struct Snapshot {
+      doocs::EqData data;
+      std::chrono::steady_clock::time_point time;
+
+      /// whether data holds a snapshot (entries may exist only to count the writes in flight)
+      bool valid{false};
+
+      /// whether the snapshot stems from a write of the backend itself
+      bool fromWrite{false};
+
+      /// number of writes to the property which have been started but not yet completed
+      size_t writesInFlight{0};
+    };
+
+    std::chrono::milliseconds _maxAge;
+    mutable std::mutex _mx;
+    std::map<std::string, Snapshot> _snapshots;
+  };
+
+} // namespace ChimeraTK
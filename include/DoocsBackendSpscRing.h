@@ -0,0 +1,91 @@
+// SPDX-FileCopyrightText: Deutsches Elektronen-Synchrotron DESY, MSK, ChimeraTK Project <chimeratk-support@desy.de>
+// SPDX-License-Identifier: LGPL-3.0-or-later
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <mutex>
+#include <new>
+
+namespace ChimeraTK {
+
+  /**
+   * Bounded lock-free ring buffer for exactly one producer thread and one consumer thread. push() and pop() never block
+   * and never allocate. Used to hand off the ZeroMQ updates from the DOOCS subscription thread to the decoding workers
+   * of the ZMQSubscriptionManager.
+   *
+   * pushLatest() keeps the most recent value in an additional overflow slot if the ring is full, so the latest value is
+   * never lost. Only the overflow slot is protected by a mutex, which is used only while the ring is full.
+   *
+   * Capacity must be a power of two. T must be default constructible and move assignable.
+   */
+  template<typename T, size_t Capacity>
+  class DoocsBackendSpscRing {
+    static_assert(Capacity > 0 && (Capacity & (Capacity - 1)) == 0, "Capacity must be a power of two");
+
+   public:
+    /// Move the value into the ring. Returns false (and leaves value untouched) if the ring is full. Producer only.
+    bool push(T&& value) {
+      auto head = _head.load(std::memory_order_relaxed);
+      if(head - _tail.load(std::memory_order_acquire) == Capacity) return false;
+      _slots[head & (Capacity - 1)] = std::move(value);
+      _head.store(head + 1, std::memory_order_release);
+      return true;
+    }
+
+    /// Like push(), but if the ring is full the value is moved into the overflow slot, replacing the value stored there
+    /// before. Once the overflow slot is used, further values go there as well until pop() has taken it, so the order is
+    /// kept. Returns the number of values replaced (0 or 1). Producer only.
+    size_t pushLatest(T&& value) {
+      // only the producer sets the flag, so the ring cannot be used after an overflow value here
+      if(!_hasOverflow.load(std::memory_order_acquire) && push(std::move(value))) return 0;
+      std::lock_guard<std::mutex> lk(_mxOverflow);
+      bool replaced = _hasOverflow.load(std::memory_order_relaxed);
+      _overflow = std::move(value);
+      _hasOverflow.store(true, std::memory_order_release);
+      return replaced ? 1 : 0;
+    }
+
+    /// Whether a value is waiting in the overflow slot. push() must not be used by the producer while this is true.
+    bool hasOverflow() const { return _hasOverflow.load(std::memory_order_acquire); }
+
+    /// Move the oldest value out of the ring, or the overflow value after the ring has become empty. Returns false if
+    /// there is no value. Consumer only.
+    bool pop(T& value) {
+      auto tail = _tail.load(std::memory_order_relaxed);
+      if(_head.load(std::memory_order_acquire) == tail) {
+        if(!_hasOverflow.load(std::memory_order_acquire)) return false;
+        std::lock_guard<std::mutex> lk(_mxOverflow);
+        value = std::move(_overflow);
+        _hasOverflow.store(false, std::memory_order_release);
+        return true;
+      }
+      value = std::move(_slots[tail & (Capacity - 1)]);
+      _tail.store(tail + 1, std::memory_order_release);
+      return true;
+    }
+
+    /// Discard all values. Neither push() nor pop() may be called concurrently.
+    void clear() {
+      T discard;
+      while(pop(discard)) {
+      }
+    }
+
+    static constexpr size_t capacity() { return Capacity; }
+
+   private:
+    std::array<T, Capacity> _slots{};
+
+    /// head and tail are on separate cache lines, so producer and consumer do not invalidate each other's cache
+    alignas(64) std::atomic<size_t> _head{0};
+    alignas(64) std::atomic<size_t> _tail{0};
+
+    /// latest value which did not fit into the ring, see pushLatest()
+    std::mutex _mxOverflow;
+    T _overflow{};
+    std::atomic<bool> _hasOverflow{false};
+  };
+
+} // namespace ChimeraTK
@@ -0,0 +1,139 @@
+// SPDX-FileCopyrightText: Deutsches Elektronen-Synchrotron DESY, MSK, ChimeraTK Project <chimeratk-support@desy.de>
+// SPDX-License-Identifier: LGPL-3.0-or-later
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace ChimeraTK {
+
+  /**
+   * Instrumentation counters of a DoocsBackend. All counters are lock-free atomics, updated with relaxed ordering, so
+   * the instrumentation can be used in the data path without noticable overhead. The values are exposed through the
+   * read-only registers below registerPrefix (see DoocsBackendStatisticsAccessor).
+   *
+   * Latencies are recorded in a histogram with fixed bucket limits (in microseconds). Bucket i counts all calls with a
+   * latency <= bucketLimitsUs[i] (and larger than the previous limit), the last bucket counts all calls exceeding the
+   * highest limit.
+   */
+  class DoocsBackendStatistics {
+   public:
+    /// Name of the register directory containing the statistics registers
+    static constexpr const char* registerPrefix = "/_stats";
+
+    static constexpr std::array<int64_t, 9> bucketLimitsUs{100, 300, 1000, 3000, 10000, 30000, 100000, 300000, 1000000};
+    static constexpr size_t nBuckets = bucketLimitsUs.size() + 1;
+
+    /// Names of the available statistics registers (without prefix). Array registers have nBuckets elements.
+    static const std::vector<std::string>& getScalarRegisterNames() {
+      static const std::vector<std::string> names{"rpc_read_count", "rpc_read_errors", "rpc_write_count",
+          "rpc_write_errors", "zmq_update_count", "zmq_error_count", "zmq_queue_depth_max", "initial_value_poll_count",
+          "async_write_coalesced_count", "zmq_buffer_count", "rpc_timeout_count",
+          "suppressed_update_count", "zmq_handoff_dropped_count"};
+      return names;
+    }
+    static const std::vector<std::string>& getArrayRegisterNames() {
+      static const std::vector<std::string> names{"rpc_latency_us", "rpc_latency_bucket_limits_us"};
+      return names;
+    }
+
+    /// Record a completed RPC read (eq.get) or write (eq.set) call
+    void recordRead(std::chrono::steady_clock::duration latency, bool success) {
+      rpcReadCount.fetch_add(1, std::memory_order_relaxed);
+      if(!success) rpcReadErrors.fetch_add(1, std::memory_order_relaxed);
+      recordLatency(latency);
+    }
+    void recordWrite(std::chrono::steady_clock::duration latency, bool success) {
+      rpcWriteCount.fetch_add(1, std::memory_order_relaxed);
+      if(!success) rpcWriteErrors.fetch_add(1, std::memory_order_relaxed);
+      recordLatency(latency);
+    }
+
+    /// Record an update received through ZeroMQ, with the fill level of the notification queue after pushing
+    void recordZmqUpdate(size_t queueDepth) {
+      zmqUpdateCount.fetch_add(1, std::memory_order_relaxed);
+      auto depth = static_cast<int64_t>(queueDepth);
+      auto max = zmqQueueDepthMax.load(std::memory_order_relaxed);
+      while(depth > max && !zmqQueueDepthMax.compare_exchange_weak(max, depth, std::memory_order_relaxed)) {
+      }
+    }
+    void recordZmqError() { zmqErrorCount.fetch_add(1, std::memory_order_relaxed); }
+
+    void recordInitialValuePoll() { initialValuePollCount.fetch_add(1, std::memory_order_relaxed); }
+
+    /// Record a queued asynchronous write which has replaced a pending value before it was sent
+    void recordAsyncWriteCoalesced() { asyncWriteCoalescedCount.fetch_add(1, std::memory_order_relaxed); }
+
+    /// Record an RPC call which has timed out resp. exceeded the deadline (see DoocsBackendTimedRpc)
+    void recordTimeout() { rpcTimeoutCount.fetch_add(1, std::memory_order_relaxed); }
+
+    /// Record the allocation of a buffer for ZeroMQ notifications (see DoocsBackendEqDataPool)
+    void recordZmqBufferAllocation() { zmqBufferCount.fetch_add(1, std::memory_order_relaxed); }
+
+    /// Record an update dropped by the change filter of an accessor (see DoocsBackendChangeFilter)
+    void recordSuppressedUpdate() { suppressedUpdateCount.fetch_add(1, std::memory_order_relaxed); }
+
+    /// Record ZeroMQ updates dropped because the decoding worker could not keep up (see CDD parameter zmqWorkers)
+    void recordZmqHandOffDropped(size_t count) {
+      zmqHandOffDroppedCount.fetch_add(int64_t(count), std::memory_order_relaxed);
+    }
+
+    /// Obtain current value(s) of the statistics register with the given name (without prefix). Returns an empty
+    /// vector if the name is unknown.
+    std::vector<int64_t> get(const std::string& name) const {
+      if(name == "rpc_read_count") return {rpcReadCount.load(std::memory_order_relaxed)};
+      if(name == "rpc_read_errors") return {rpcReadErrors.load(std::memory_order_relaxed)};
+      if(name == "rpc_write_count") return {rpcWriteCount.load(std::memory_order_relaxed)};
+      if(name == "rpc_write_errors") return {rpcWriteErrors.load(std::memory_order_relaxed)};
+      if(name == "zmq_update_count") return {zmqUpdateCount.load(std::memory_order_relaxed)};
+      if(name == "zmq_error_count") return {zmqErrorCount.load(std::memory_order_relaxed)};
+      if(name == "zmq_queue_depth_max") return {zmqQueueDepthMax.load(std::memory_order_relaxed)};
+      if(name == "initial_value_poll_count") return {initialValuePollCount.load(std::memory_order_relaxed)};
+      if(name == "async_write_coalesced_count") return {asyncWriteCoalescedCount.load(std::memory_order_relaxed)};
+      if(name == "zmq_buffer_count") return {zmqBufferCount.load(std::memory_order_relaxed)};
+      if(name == "rpc_timeout_count") return {rpcTimeoutCount.load(std::memory_order_relaxed)};
+      if(name == "suppressed_update_count") return {suppressedUpdateCount.load(std::memory_order_relaxed)};
+      if(name == "zmq_handoff_dropped_count") return {zmqHandOffDroppedCount.load(std::memory_order_relaxed)};
+      if(name == "rpc_latency_us") {
+        std::vector<int64_t> values;
+        for(auto& bucket : rpcLatency) values.push_back(bucket.load(std::memory_order_relaxed));
+        return values;
+      }
+      if(name == "rpc_latency_bucket_limits_us") {
+        // the last bucket has no upper limit, report -1 for it
+        std::vector<int64_t> values(bucketLimitsUs.begin(), bucketLimitsUs.end());
+        values.push_back(-1);
+        return values;
+      }
+      return {};
+    }
+
+   private:
+    void recordLatency(std::chrono::steady_clock::duration latency) {
+      auto us = std::chrono::duration_cast<std::chrono::microseconds>(latency).count();
+      size_t bucket = 0;
+      while(bucket < bucketLimitsUs.size() && us > bucketLimitsUs[bucket]) ++bucket;
+      rpcLatency[bucket].fetch_add(1, std::memory_order_relaxed);
+    }
+
+    std::atomic<int64_t> rpcReadCount{0};
+    std::atomic<int64_t> rpcReadErrors{0};
+    std::atomic<int64_t> rpcWriteCount{0};
+    std::atomic<int64_t> rpcWriteErrors{0};
+    std::atomic<int64_t> zmqUpdateCount{0};
+    std::atomic<int64_t> zmqErrorCount{0};
+    std::atomic<int64_t> zmqQueueDepthMax{0};
+    std::atomic<int64_t> initialValuePollCount{0};
+    std::atomic<int64_t> asyncWriteCoalescedCount{0};
+    std::atomic<int64_t> zmqBufferCount{0};
+    std::atomic<int64_t> rpcTimeoutCount{0};
+    std::atomic<int64_t> suppressedUpdateCount{0};
+    std::atomic<int64_t> zmqHandOffDroppedCount{0};
+    std::array<std::atomic<int64_t>, nBuckets> rpcLatency{};
+  };
+
+} // namespace ChimeraTK
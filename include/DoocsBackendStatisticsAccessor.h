@@ -0,0 +1,104 @@
+// SPDX-FileCopyrightText: Deutsches Elektronen-Synchrotron DESY, MSK, ChimeraTK Project <chimeratk-support@desy.de>
+// SPDX-License-Identifier: LGPL-3.0-or-later
+#pragma once
+
+#include "DoocsBackend.h"
+#include "DoocsBackendStatistics.h"
+
+#include <ChimeraTK/Exception.h>
+#include <ChimeraTK/NDRegisterAccessor.h>
+#include <ChimeraTK/SupportedUserTypes.h>
+
+namespace ChimeraTK {
+
+  /**
+   * Read-only accessor for the statistics registers below DoocsBackendStatistics::registerPrefix. The values are taken
+   * from the DoocsBackendStatistics of the backend, no communication with the DOOCS server takes place.
+   */
+  template<typename UserType>
+  class DoocsBackendStatisticsAccessor : public NDRegisterAccessor<UserType> {
+   public:
+    DoocsBackendStatisticsAccessor(boost::shared_ptr<DoocsBackend> backend, const std::string& registerPathName,
+        const std::string& name, size_t numberOfWords, size_t wordOffsetInRegister, AccessModeFlags flags);
+
+    void doReadTransferSynchronously() override { _values = _backend->_statistics.get(_name); }
+
+    bool doWriteTransfer(VersionNumber) override { return false; }
+
+    void doPreRead(TransferType) override {
+      if(!_backend->isOpen()) throw ChimeraTK::logic_error("Read operation not allowed while device is closed.");
+    }
+
+    void doPreWrite(TransferType, VersionNumber) override {
+      throw ChimeraTK::logic_error("Try to write read-only register \"" + this->getName() + "\".");
+    }
+
+    void doPostRead(TransferType, bool hasNewData) override {
+      if(!hasNewData) return;
+      for(size_t i = 0; i < _nElements; ++i) {
+        NDRegisterAccessor<UserType>::buffer_2D[0][i] = numericToUserType<UserType>(_values[_elementOffset + i]);
+      }
+      TransferElement::_versionNumber = {};
+      TransferElement::setDataValidity(DataValidity::ok);
+    }
+
+    bool isReadOnly() const override { return true; }
+
+    bool isReadable() const override { return true; }
+
+    bool isWriteable() const override { return false; }
+
+    bool mayReplaceOther(const boost::shared_ptr<TransferElement const>&) const override { return false; }
+
+    std::vector<boost::shared_ptr<TransferElement>> getHardwareAccessingElements() override {
+      return {boost::enable_shared_from_this<TransferElement>::shared_from_this()};
+    }
+
+    std::list<boost::shared_ptr<ChimeraTK::TransferElement>> getInternalElements() override { return {}; }
+
+    void replaceTransferElement(boost::shared_ptr<TransferElement> /*newElement*/) override {}
+
+   protected:
+    boost::shared_ptr<DoocsBackend> _backend;
+
+    /// name of the statistics register without prefix
+    std::string _name;
+
+    size_t _nElements;
+    size_t _elementOffset;
+
+    /// values obtained in the last read transfer
+    std::vector<int64_t> _values;
+  };
+
+  /********************************************************************************************************************/
+
+  template<typename UserType>
+  DoocsBackendStatisticsAccessor<UserType>::DoocsBackendStatisticsAccessor(boost::shared_ptr<DoocsBackend> backend,
+      const std::string& registerPathName, const std::string& name, size_t numberOfWords, size_t wordOffsetInRegister,
+      AccessModeFlags flags)
+  : NDRegisterAccessor<UserType>(registerPathName, flags), _backend(std::move(backend)), _name(name),
+    _nElements(numberOfWords), _elementOffset(wordOffsetInRegister) {
+    flags.checkForUnknownFlags({});
+
+    auto length = _backend->_statistics.get(_name).size();
+    if(length == 0) {
+      throw ChimeraTK::logic_error("Unknown statistics register: " + registerPathName);
+    }
+    if(_elementOffset >= length) {
+      throw ChimeraTK::logic_error("Requested offset exceeds the length of the register " + registerPathName);
+    }
+    if(_nElements == 0) {
+      _nElements = length - _elementOffset;
+    }
+    if(_nElements + _elementOffset > length) {
+      throw ChimeraTK::logic_error("Requested number of words exceeds the length of the register " + registerPathName);
+    }
+
+    NDRegisterAccessor<UserType>::buffer_2D.resize(1);
+    NDRegisterAccessor<UserType>::buffer_2D[0].resize(_nElements);
+  }
+
+  /********************************************************************************************************************/
+
+} // namespace ChimeraTK
@@ -0,0 +1,43 @@
+// SPDX-FileCopyrightText: Deutsches Elektronen-Synchrotron DESY, MSK, ChimeraTK Project <chimeratk-support@desy.de>
+// SPDX-License-Identifier: LGPL-3.0-or-later
+#pragma once
+
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace ChimeraTK {
+
+  /**
+   * CPU affinity and scheduling settings for threads outside the control of the backend, i.e. the ZeroMQ subscription
+   * threads of the DOOCS client library (CDD parameters zmqCpus, zmqSchedPolicy and zmqPriority). The settings are
+   * applied by the thread itself, when the ZMQSubscriptionManager sees it for the first time in its callback.
+   */
+  struct DoocsBackendThreadSettings {
+    /// CPUs the thread may run on, empty to leave the affinity unchanged
+    std::vector<int> cpus;
+
+    /// scheduling policy (SCHED_OTHER, SCHED_FIFO, ...), unset to leave the scheduling unchanged
+    std::optional<int> policy;
+
+    /// scheduling priority, used together with the policy
+    int priority{0};
+
+    bool isEmpty() const { return cpus.empty() && !policy; }
+
+    /**
+     * Create settings from the CDD parameter values (each may be empty):
+     *  - cpus: comma separated list of CPU numbers and ranges, e.g. "2,3,8-11"
+     *  - policy: "other", "batch", "idle", "fifo" or "rr"
+     *  - priority: priority for the policy. If given without policy, "fifo" is used.
+     *
+     * Throws ChimeraTK::logic_error on invalid values.
+     */
+    static DoocsBackendThreadSettings parse(
+        const std::string& cpus, const std::string& policy, const std::string& priority);
+
+    /// Apply the settings to the calling thread. Returns an error message, or an empty string on success.
+    std::string applyToCurrentThread() const;
+  };
+
+} // namespace ChimeraTK
@@ -0,0 +1,126 @@
+// SPDX-FileCopyrightText: Deutsches Elektronen-Synchrotron DESY, MSK, ChimeraTK Project <chimeratk-support@desy.de>
+// SPDX-License-Identifier: LGPL-3.0-or-later
+#pragma once
+
+#include <doocs/EqCall.h>
+
+#include <chrono>
+#include <future>
+#include <memory>
+#include <optional>
+#include <string>
+
+namespace ChimeraTK {
+
+  /**
+   * Deadline for the RPC calls of all DoocsBackend instances made by the current thread, while the object exists.
+   * Calls are cut short when the deadline is reached, and no more calls are started after it has passed (they fail
+   * immediately with a runtime_error). This allows e.g. to bound the time a TransferGroup::read() may take:
+   *
+   *   {
+   *     DoocsBackendRpcDeadline deadline(std::chrono::milliseconds(200));
+   *     group.read();
+   *   }
+   *
+   * Deadlines can be nested, the inner one replaces the outer one until it is destroyed.
+   */
+  class DoocsBackendRpcDeadline {
+   public:
+    explicit DoocsBackendRpcDeadline(std::chrono::steady_clock::time_point deadline);
+    explicit DoocsBackendRpcDeadline(std::chrono::steady_clock::duration timeout)
+    : DoocsBackendRpcDeadline(std::chrono::steady_clock::now() + timeout) {}
+    ~DoocsBackendRpcDeadline();
+
+    DoocsBackendRpcDeadline(const DoocsBackendRpcDeadline&) = delete;
+    DoocsBackendRpcDeadline& operator=(const DoocsBackendRpcDeadline&) = delete;
+
+    /// Deadline of the current thread, if any
+    static std::optional<std::chrono::steady_clock::time_point> current();
+
+   private:
+    std::optional<std::chrono::steady_clock::time_point> _previous;
+  };
+
+  /********************************************************************************************************************/
+
+  /**
+   * Replacement for doocs::EqCall which applies a timeout and the DoocsBackendRpcDeadline of the current thread to
+   * get() and set().
+   *
+   * The DOOCS client library does not allow to interrupt a call, so calls with a timeout are executed by a worker
+   * thread, and the caller stops waiting when the timeout expires. The workers are shared by all instances and kept per
+   * location (the address without the property name), up to maxWorkersPerLocation each. They are started on demand
+   * and end after being idle for workerIdleTime. The data is handed over to the worker by swapping the buffers, so it
+   * is not copied. Without timeout and deadline, the call is executed directly in the calling thread.
+   *
+   * A call which has timed out continues in the background. As long as it has not returned, further calls to the same
+   * location fail immediately, so a hanging server does not occupy further workers or stall further callers.
+   *
+   * The workers are detached threads, since a hanging call cannot be joined. The registry of the locations is hence a
+   * deliberately leaked singleton which is never destroyed, and each worker keeps its location alive. At exit, workers
+   * still hanging in a call are terminated with the process and never access destroyed objects of this class.
+   *
+   * A timed-out call returns doocs::TransactionResult::transport_error, hasTimedOut() then returns true and
+   * getErrorMessage() provides the error message to be used instead of the one in dst. The content of src is then still
+   * in use by the abandoned call, so src is left empty with its data type only.
+   */
+  class DoocsBackendTimedRpc {
+   public:
+    /// Create call object for the property with the given address, which selects the workers to use
+    explicit DoocsBackendTimedRpc(std::string address = {}) : _address(std::move(address)) {}
+    DoocsBackendTimedRpc(const DoocsBackendTimedRpc&) = delete;
+    DoocsBackendTimedRpc& operator=(const DoocsBackendTimedRpc&) = delete;
+
+    /// Like doocs::EqCall::get(), with the given timeout (0 = no timeout)
+    int get(doocs::EqAdr* ea, doocs::EqData* src, doocs::EqData* dst, std::chrono::milliseconds timeout);
+
+    /// Like doocs::EqCall::set(), with the given timeout (0 = no timeout)
+    int set(doocs::EqAdr* ea, doocs::EqData* src, doocs::EqData* dst, std::chrono::milliseconds timeout);
+
+    /// Whether the last call has timed out (or could not be started due to the deadline or a hanging call)
+    bool hasTimedOut() const { return _timedOut; }
+
+    /// Error message of the last failed call
+    std::string getErrorMessage(const doocs::EqData& dst) const;
+
+    /// Result of a call started with getAsync()
+    struct AsyncResult {
+      int rc;
+      doocs::EqAdr ea;
+      std::string message;
+      std::chrono::steady_clock::duration latency;
+    };
+
+    /// Start a get() call of the given address on the workers of its location without waiting for the result, e.g. to
+    /// establish the connection in advance. Nobody needs to wait for the returned future. Fails immediately if a call to
+    /// the location has timed out and not yet returned, or if maxWorkersPerLocation such calls are already pending.
+    static std::future<AsyncResult> getAsync(const std::string& address, const doocs::EqAdr& ea);
+
+    /// Maximum number of worker threads per location
+    static constexpr size_t maxWorkersPerLocation = 8;
+
+    /// Time after which an idle worker thread ends
+    static constexpr std::chrono::seconds workerIdleTime{10};
+
+   private:
+    struct Job;
+    struct Location;
+
+    /// Obtain the workers for the location of the given address
+    static std::shared_ptr<Location> getLocation(const std::string& address);
+
+    int call(bool isSet, doocs::EqAdr* ea, doocs::EqData* src, doocs::EqData* dst, std::chrono::milliseconds timeout);
+
+    std::string _address;
+    doocs::EqCall _eq;
+    bool _timedOut{false};
+    std::string _timeoutReason;
+
+    /// workers of the location, obtained on the first call with timeout
+    std::shared_ptr<Location> _location;
+
+    /// job of the last call, reused for the next call unless it has been abandoned
+    std::shared_ptr<Job> _job;
+  };
+
+} // namespace ChimeraTK
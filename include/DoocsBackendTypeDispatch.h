@@ -0,0 +1,176 @@
+// SPDX-FileCopyrightText: Deutsches Elektronen-Synchrotron DESY, MSK, ChimeraTK Project <chimeratk-support@desy.de>
+// SPDX-License-Identifier: LGPL-3.0-or-later
+#pragma once
+
+#include <ChimeraTK/SupportedUserTypes.h>
+
+#include <doocs/EqData.h>
+
+#include <eq_types.h>
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+namespace ChimeraTK {
+
+  /**
+   * Compile-time table of the conversion kernels between the numeric DOOCS data types and the UserType of an accessor
+   * (see DoocsBackendNumericRegisterAccessor). The table is indexed by the DOOCS type id, so obtaining the kernels for
+   * the type of received data is a single lookup instead of a switch, and the kernels themselves do not branch on the
+   * type per element.
+   *
+   * Array types with direct access to the DOOCS buffer are copied with memcpy() if the types match, otherwise with a
+   * vectorisable std::transform(). Byte arrays (DATA_A_BYTE) hold signed 8 bit values, so only int8 is copied with
+   * memcpy(). Other UserTypes, including uint8, are converted with clamping like all other types, i.e. negative bytes
+   * are read as 0 into uint8. All other types (including scalars) are accessed through the element getters and setters
+   * of doocs::EqData.
+   */
+  template<typename UserType>
+  class DoocsBackendTypeDispatch {
+   public:
+    /// Convert n elements starting at offset from the data into target
+    using ReadKernel = void (*)(const doocs::EqData& data, UserType* target, size_t offset, size_t n);
+
+    /// Convert n elements from source into the data, starting at offset. Scalars are set through set(value).
+    using WriteKernel = void (*)(doocs::EqData& data, const UserType* source, size_t offset, size_t n);
+
+    struct Entry {
+      ReadKernel read{nullptr};
+      WriteKernel write{nullptr};
+    };
+
+    /// Obtain the kernels for the given DOOCS type. Returns nullptr if the type is not numeric.
+    static const Entry* find(int doocsType) {
+      if(doocsType < 0 || size_t(doocsType) >= table.size() || !table[size_t(doocsType)].read) return nullptr;
+      return &table[size_t(doocsType)];
+    }
+
+   private:
+    /// How the values of a DOOCS type are accessed
+    enum class Access { element, floatArray, doubleArray, intArray, longArray, shortArray, byteArray };
+
+    /// Whether values can be copied with memcpy() between an array of RawType and the UserType
+    template<typename RawType>
+    static constexpr bool isRawCopy() {
+      return std::is_same_v<UserType, RawType>;
+    }
+
+    /// Read element through the getter for the C++ type T
+    template<typename T>
+    static T get(const doocs::EqData& data, int index) {
+      if constexpr(std::is_same_v<T, bool>) return data.get_bool(index);
+      if constexpr(std::is_same_v<T, int16_t>) return data.get_short(index);
+      if constexpr(std::is_same_v<T, uint16_t>) return data.get_ushort(index);
+      if constexpr(std::is_same_v<T, int32_t>) return data.get_int(index);
+      if constexpr(std::is_same_v<T, uint32_t>) return data.get_uint(index);
+      if constexpr(std::is_same_v<T, int64_t>) return data.get_long(index);
+      if constexpr(std::is_same_v<T, uint64_t>) return data.get_ulong(index);
+      if constexpr(std::is_same_v<T, float>) return data.get_float(index);
+      if constexpr(std::is_same_v<T, double>) return data.get_double(index);
+    }
+
+    template<Access A, typename D>
+    static auto* arrayPointer(D& data) {
+      if constexpr(A == Access::floatArray) return data.get_float_array();
+      if constexpr(A == Access::doubleArray) return data.get_double_array();
+      if constexpr(A == Access::intArray) return data.get_int_array();
+      if constexpr(A == Access::longArray) return data.get_long_array();
+      if constexpr(A == Access::shortArray) return data.get_short_array();
+      if constexpr(A == Access::byteArray) {
+        using Byte = std::conditional_t<std::is_const_v<D>, const int8_t, int8_t>;
+        return reinterpret_cast<Byte*>(data.get_char_array());
+      }
+    }
+
+    template<Access A, typename T>
+    static void readKernel(const doocs::EqData& data, UserType* target, size_t offset, size_t n) {
+      if constexpr(A == Access::element) {
+        for(size_t i = 0; i < n; ++i) {
+          target[i] = numericToUserType<UserType>(get<T>(data, int(i + offset)));
+        }
+      }
+      else {
+        const auto* source = arrayPointer<A>(data);
+        using SourceType = std::remove_const_t<std::remove_pointer_t<decltype(source)>>;
+        assert(source);
+        source += offset;
+        if constexpr(isRawCopy<SourceType>()) {
+          std::memcpy(target, source, n * sizeof(SourceType));
+        }
+        else {
+          std::transform(source, source + n, target, [](SourceType v) { return numericToUserType<UserType>(v); });
+        }
+      }
+    }
+
+    template<Access A, typename T>
+    static void writeKernel(doocs::EqData& data, const UserType* source, size_t offset, size_t n) {
+      if constexpr(A == Access::element) {
+        if(data.array_length() == 0) {
+          // scalar (IFFF, IIII and string are handled in different accessors)
+          data.set(userTypeToNumeric<T>(source[0]));
+          return;
+        }
+        for(size_t i = 0; i < n; ++i) {
+          data.set(userTypeToNumeric<T>(source[i]), int(i + offset));
+        }
+      }
+      else {
+        auto* target = arrayPointer<A>(data);
+        using TargetType = std::remove_pointer_t<decltype(target)>;
+        assert(target);
+        target += offset;
+        if constexpr(isRawCopy<TargetType>()) {
+          std::memcpy(target, source, n * sizeof(TargetType));
+        }
+        else {
+          std::transform(source, source + n, target, [](UserType v) { return userTypeToNumeric<TargetType>(v); });
+        }
+      }
+    }
+
+    template<Access A, typename T>
+    static constexpr Entry entry() {
+      return {&readKernel<A, T>, &writeKernel<A, T>};
+    }
+
+    /// DOOCS type ids are small integers, the table covers all numeric types
+    static constexpr size_t tableSize = 256;
+
+    static constexpr std::array<Entry, tableSize> makeTable() {
+      std::array<Entry, tableSize> t{};
+      auto set = [&t](int doocsType, Entry e) { t.at(size_t(doocsType)) = e; };
+      set(DATA_BOOL, entry<Access::element, bool>());
+      set(DATA_A_BOOL, entry<Access::shortArray, int16_t>());
+      set(DATA_SHORT, entry<Access::element, int16_t>());
+      set(DATA_A_SHORT, entry<Access::shortArray, int16_t>());
+      set(DATA_USHORT, entry<Access::element, uint16_t>());
+      set(DATA_A_USHORT, entry<Access::element, uint16_t>());
+      set(DATA_INT, entry<Access::element, int32_t>());
+      set(DATA_IIII, entry<Access::element, int32_t>());
+      set(DATA_A_INT, entry<Access::intArray, int32_t>());
+      set(DATA_UINT, entry<Access::element, uint32_t>());
+      set(DATA_A_UINT, entry<Access::element, uint32_t>());
+      set(DATA_LONG, entry<Access::element, int64_t>());
+      set(DATA_A_LONG, entry<Access::longArray, int64_t>());
+      set(DATA_ULONG, entry<Access::element, uint64_t>());
+      set(DATA_A_ULONG, entry<Access::element, uint64_t>());
+      set(DATA_FLOAT, entry<Access::element, float>());
+      set(DATA_GSPECTRUM, entry<Access::element, float>());
+      set(DATA_SPECTRUM, entry<Access::floatArray, float>());
+      set(DATA_A_FLOAT, entry<Access::floatArray, float>());
+      set(DATA_DOUBLE, entry<Access::element, double>());
+      set(DATA_A_DOUBLE, entry<Access::doubleArray, double>());
+      set(DATA_A_BYTE, entry<Access::byteArray, int8_t>());
+      return t;
+    }
+
+    static constexpr std::array<Entry, tableSize> table = makeTable();
+  };
+
+} // namespace ChimeraTK
@@ -0,0 +1,212 @@
+// SPDX-FileCopyrightText: Deutsches Elektronen-Synchrotron DESY, MSK, ChimeraTK Project <chimeratk-support@desy.de>
+// SPDX-License-Identifier: LGPL-3.0-or-later
+#pragma once
+
+#include "DoocsBackendRegisterAccessor.h"
+
+#include <doocs/EqCall.h>
+
+#include <string>
+#include <type_traits>
+
+namespace ChimeraTK {
+
+  /**
+   * Accessor for a single field of a DOOCS property of the type USTR (int, float, float, time_t, string). As for IFFF,
+   * the fields are accessed as separate scalar registers (I, F1, F2, TM and STR), which share the raw element of the
+   * property, so all fields in a TransferGroup are transferred with a single RPC call. The STR field can only be
+   * accessed with UserType std::string.
+   */
+  template<typename UserType>
+  class DoocsBackendUSTRRegisterAccessor : public DoocsBackendRegisterAccessor<UserType> {
+   public:
+    ~DoocsBackendUSTRRegisterAccessor() override;
+
+   protected:
+    DoocsBackendUSTRRegisterAccessor(boost::shared_ptr<DoocsBackend> backend, const std::string& path,
+        const std::string& field, const std::string& registerPathName, size_t numberOfWords,
+        size_t wordOffsetInRegister, AccessModeFlags flags);
+
+    void doPostRead(TransferType type, bool hasNewData) override;
+
+    void doPreWrite(TransferType type, VersionNumber version) override;
+
+    bool mayReplaceOther(const boost::shared_ptr<TransferElement const>& other) const override {
+      auto rhsCasted = boost::dynamic_pointer_cast<const DoocsBackendUSTRRegisterAccessor<UserType>>(other);
+      if(!rhsCasted) return false;
+      if(rhsCasted.get() == this) return false;
+      if(_path != rhsCasted->_path) return false;
+      if(field != rhsCasted->field) return false;
+      return true;
+    }
+
+    /// Fields of the USTR structure, the values are used as unit index of the raw element
+    enum class Field { I = 0, F1 = 1, F2 = 2, TM = 3, STR = 4 };
+    Field field;
+
+    using NDRegisterAccessor<UserType>::buffer_2D;
+    using DoocsBackendRegisterAccessor<UserType>::src;
+    using DoocsBackendRegisterAccessor<UserType>::_path;
+
+    friend class DoocsBackend;
+  };
+
+  /**********************************************************************************************************************/
+
+  template<typename UserType>
+  DoocsBackendUSTRRegisterAccessor<UserType>::DoocsBackendUSTRRegisterAccessor(boost::shared_ptr<DoocsBackend> backend,
+      const std::string& path, const std::string& fieldName, const std::string& registerPathName, size_t numberOfWords,
+      size_t wordOffsetInRegister, AccessModeFlags flags)
+  : DoocsBackendRegisterAccessor<UserType>(
+        backend, path, registerPathName, numberOfWords, wordOffsetInRegister, flags) {
+    try {
+      // number of words and offset must be at fixed values
+      if(numberOfWords > 1 || wordOffsetInRegister != 0) {
+        throw ChimeraTK::logic_error("Register '" + this->getName() + "' is scalar.");
+      }
+      this->nElements = 1; // needed since DOOCS reports the length of the string
+
+      // determine field
+      if(fieldName == "I") {
+        field = Field::I;
+      }
+      else if(fieldName == "F1") {
+        field = Field::F1;
+      }
+      else if(fieldName == "F2") {
+        field = Field::F2;
+      }
+      else if(fieldName == "TM") {
+        field = Field::TM;
+      }
+      else if(fieldName == "STR") {
+        field = Field::STR;
+      }
+      else {
+        throw ChimeraTK::logic_error("Unknown field name '" + fieldName + "' for DOOCS USTR data type.");
+      }
+
+      // check UserType
+      if(field == Field::STR && !std::is_same_v<UserType, std::string>) {
+        throw ChimeraTK::logic_error("Trying to access a string DOOCS property with a non-string user data type.");
+      }
+
+      // check data type
+      if(src.type() != DATA_USTR) {
+        throw ChimeraTK::logic_error("DOOCS data type " + std::to_string(src.type()) +
+            " not supported by DoocsBackendUSTRRegisterAccessor."); // LCOV_EXCL_LINE (already prevented in the Backend)
+      }
+
+      auto unit = static_cast<size_t>(field);
+      this->useRawElement(5, unit, unit + 1);
+    }
+    catch(...) {
+      this->shutdown();
+      throw;
+    }
+  }
+
+  /**********************************************************************************************************************/
+
+  template<typename UserType>
+  DoocsBackendUSTRRegisterAccessor<UserType>::~DoocsBackendUSTRRegisterAccessor() {
+    this->shutdown();
+  }
+
+  /**********************************************************************************************************************/
+
+  template<typename UserType>
+  void DoocsBackendUSTRRegisterAccessor<UserType>::doPostRead(TransferType type, bool hasNewData) {
+    DoocsBackendRegisterAccessor<UserType>::doPostRead(type, hasNewData);
+    if(!hasNewData) return;
+
+    // copy data into our buffer
+    USTR* data = this->readBuffer().get_ustr();
+    if(!data) {
+      throw ChimeraTK::runtime_error("DOOCS property '" + _path + "' did not return USTR data.");
+    }
+    switch(field) {
+      case Field::I: {
+        buffer_2D[0][0] = numericToUserType<UserType>(data->i1_data);
+        break;
+      }
+      case Field::F1: {
+        buffer_2D[0][0] = numericToUserType<UserType>(data->f1_data);
+        break;
+      }
+      case Field::F2: {
+        buffer_2D[0][0] = numericToUserType<UserType>(data->f2_data);
+        break;
+      }
+      case Field::TM: {
+        buffer_2D[0][0] = numericToUserType<UserType>(int64_t(data->tm_data));
+        break;
+      }
+      case Field::STR: {
+        if constexpr(std::is_same_v<UserType, std::string>) {
+          buffer_2D[0][0] = data->str_data.str_data_val ?
+              std::string(data->str_data.str_data_val, data->str_data.str_data_len) :
+              std::string();
+          // DOOCS counts the terminating zero in the length
+          auto end = buffer_2D[0][0].find('\0');
+          if(end != std::string::npos) buffer_2D[0][0].resize(end);
+        }
+        break;
+      }
+      default: {
+        assert(false); // LCOV_EXCL_LINE (cannot happen, see constructor)
+      }
+    }
+  }
+
+  /**********************************************************************************************************************/
+
+  template<typename UserType>
+  void DoocsBackendUSTRRegisterAccessor<UserType>::doPreWrite(TransferType type, VersionNumber version) {
+    // the raw element performs the read-modify-write, create it on the first write if not yet in a TransferGroup
+    this->createRawElement();
+    DoocsBackendRegisterAccessor<UserType>::doPreWrite(type, version);
+
+    // Modify our field in the raw element. The other fields have been filled in by the raw element with the current
+    // value of the property (read-modify-write), unless they are written in the same transaction by other accessors
+    // sharing the raw element. The string is owned by the EqData, hence the structure is set as a whole.
+    USTR* data = this->writeBuffer().get_ustr();
+    if(!data) {
+      throw ChimeraTK::runtime_error("DOOCS property '" + _path + "' did not return USTR data."); // LCOV_EXCL_LINE
+    }
+    auto i1 = data->i1_data;
+    auto f1 = data->f1_data;
+    auto f2 = data->f2_data;
+    auto tm = data->tm_data;
+    std::string str = data->str_data.str_data_val ? data->str_data.str_data_val : "";
+    switch(field) {
+      case Field::I: {
+        i1 = userTypeToNumeric<int>(buffer_2D[0][0]);
+        break;
+      }
+      case Field::F1: {
+        f1 = userTypeToNumeric<float>(buffer_2D[0][0]);
+        break;
+      }
+      case Field::F2: {
+        f2 = userTypeToNumeric<float>(buffer_2D[0][0]);
+        break;
+      }
+      case Field::TM: {
+        tm = time_t(userTypeToNumeric<int64_t>(buffer_2D[0][0]));
+        break;
+      }
+      case Field::STR: {
+        if constexpr(std::is_same_v<UserType, std::string>) {
+          str = buffer_2D[0][0];
+        }
+        break;
+      }
+      default: {
+        assert(false); // LCOV_EXCL_LINE (cannot happen, see constructor)
+      }
+    }
+    this->writeBuffer().set(i1, f1, f2, tm, str);
+  }
+
+} // namespace ChimeraTK
@@ -0,0 +1,59 @@
+// SPDX-FileCopyrightText: Deutsches Elektronen-Synchrotron DESY, MSK, ChimeraTK Project <chimeratk-support@desy.de>
+// SPDX-License-Identifier: LGPL-3.0-or-later
+#pragma once
+
+#include <ChimeraTK/async/DataConsistencyKey.h>
+#include <ChimeraTK/async/DataConsistencyRealm.h>
+#include <ChimeraTK/VersionNumber.h>
+
+#include <doocs/EqData.h>
+
+#include <array>
+#include <atomic>
+#include <memory>
+
+namespace ChimeraTK {
+
+  /**
+   * Cache of the most recent eventId to VersionNumber mappings of the DataConsistencyRealm used by a DoocsBackend.
+   *
+   * Typically many accessors receive data with the same eventId in a short time. Each of them needs the VersionNumber
+   * for that eventId, which otherwise requires a lookup in the realm under its mutex. The cache has a small number of
+   * slots, selected by the eventId, which are read and replaced atomically, so lookups of a cached eventId from
+   * different accessors do not contend for the realm's mutex. Note that std::atomic<std::shared_ptr> is not lock-free
+   * (libstdc++ protects it with a short internal lock), and each cache miss allocates a new slot entry.
+   *
+   * The realm always returns the same VersionNumber for an eventId as long as the eventId is within its history, so
+   * the cache does not change the result except for eventIds which the realm has already forgotten.
+   */
+  class DoocsBackendVersionCache {
+   public:
+    explicit DoocsBackendVersionCache(std::shared_ptr<async::DataConsistencyRealm> realm) : _realm(std::move(realm)) {}
+
+    /// Obtain VersionNumber for the given eventId (which must not be 0)
+    VersionNumber getVersion(const doocs::EventId& eventId) {
+      auto key = eventId.to_int();
+      auto& slot = _slots[size_t(key) % nSlots];
+      auto entry = slot.load(std::memory_order_acquire);
+      if(entry && entry->eventId == key) {
+        return entry->version;
+      }
+      auto version = _realm->getVersion(async::DataConsistencyKey(key));
+      slot.store(std::make_shared<const Entry>(Entry{key, version}), std::memory_order_release);
+      return version;
+    }
+
+   private:
+    struct Entry {
+      int64_t eventId;
+      VersionNumber version;
+    };
+
+    /// number of slots, i.e. of consecutive eventIds cached
+    static constexpr size_t nSlots = 16;
+
+    std::shared_ptr<async::DataConsistencyRealm> _realm;
+    std::array<std::atomic<std::shared_ptr<const Entry>>, nSlots> _slots;
+  };
+
+} // namespace ChimeraTK
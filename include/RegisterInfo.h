@@ -3,6 +3,11 @@
 #include <ChimeraTK/BackendRegisterCatalogue.h>
 #include <ChimeraTK/BackendRegisterInfoBase.h>
 
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <string>
+
 /**********************************************************************************************************************/
 
 class DoocsBackendRegisterInfo;
@@ -15,10 +20,25 @@ class DoocsBackendRegisterCatalogue : public ChimeraTK::BackendRegisterCatalogue
   // skipped.
   void addProperty(const std::string& name, unsigned int length, int doocsType, ChimeraTK::AccessModeFlags flags);
 
+  // Add a read-only register which is provided by the backend itself rather than by a DOOCS property (e.g. the
+  // statistics registers). No meta data registers are provided for it.
+  void addBackendRegister(const std::string& name, unsigned int length, int doocsType);
+
   [[nodiscard]] bool isComplete() const { return _isCatalogueComplete; }
 
+  [[nodiscard]] std::unique_ptr<ChimeraTK::BackendRegisterCatalogueBase> clone() const override;
+
  private:
   bool _isCatalogueComplete{false};
+
+  // Interned location parts of the register names, shared by all registers of the same location
+  std::map<std::string, std::shared_ptr<const std::string>> _locations;
+
+  std::shared_ptr<const std::string> internLocation(const std::string& location);
+
+  // Fill location and property name of the given info from the full register name
+  void setName(DoocsBackendRegisterInfo& info, const std::string& name);
+
   friend class CatalogueFetcher;
 };
 
@@ -26,7 +46,10 @@ class DoocsBackendRegisterCatalogue : public ChimeraTK::BackendRegisterCatalogue
 
 class DoocsBackendRegisterInfo : public ChimeraTK::BackendRegisterInfoBase {
  public:
-  ChimeraTK::RegisterPath getRegisterName() const override { return _name; }
+  /// Component of the property a register refers to. Field::none refers to the payload of the entire property.
+  enum class Field : uint8_t { none, I, F1, F2, F3, TM, STR, eventId, timeStamp };
+
+  ChimeraTK::RegisterPath getRegisterName() const override;
 
   unsigned int getNumberOfElements() const override { return _length; }
 
@@ -36,17 +59,55 @@ class DoocsBackendRegisterInfo : public ChimeraTK::BackendRegisterInfoBase {
 
   bool isWriteable() const override { return _writable; }
 
-  ChimeraTK::AccessModeFlags getSupportedAccessModes() const override { return accessModeFlags; }
+  ChimeraTK::AccessModeFlags getSupportedAccessModes() const override;
 
-  const ChimeraTK::DataDescriptor& getDataDescriptor() const override { return dataDescriptor; }
+  const ChimeraTK::DataDescriptor& getDataDescriptor() const override;
 
   std::unique_ptr<BackendRegisterInfoBase> clone() const override;
 
-  ChimeraTK::RegisterPath _name;
-  unsigned int _length;
-  ChimeraTK::DataDescriptor dataDescriptor;
-  ChimeraTK::AccessModeFlags accessModeFlags{};
-  int doocsTypeId;
+  /// Return the DataDescriptor for the given DOOCS type and field. The descriptors are shared between all registers.
+  static const ChimeraTK::DataDescriptor& getSharedDataDescriptor(int doocsType, Field field = Field::none);
+
+  /// Location part of the register name (interned by the catalogue), without trailing slash
+  std::shared_ptr<const std::string> _location;
+  /// Property name without the location part, shared by all registers of the property (fields and meta data)
+  std::shared_ptr<const std::string> _property;
+  unsigned int _length{1};
+  int doocsTypeId{0};
+  /// Shared descriptor (see getSharedDataDescriptor()), nullptr for an undefined descriptor
+  const ChimeraTK::DataDescriptor* _dataDescriptor{nullptr};
+  Field _field{Field::none};
   bool _readable{true};
   bool _writable{true};
+  /// Whether the property is published through ZeroMQ (AccessMode::wait_for_new_data)
+  bool _zmqAvailable{false};
+  /// Whether the register refers to a DOOCS property, or is provided by the backend itself
+  bool _isDoocsProperty{true};
+};
+
+/**********************************************************************************************************************/
+
+/**
+ * Read-only view onto an immutable catalogue snapshot shared with the backend. This is what
+ * DoocsBackend::getRegisterCatalogue() hands out, so the catalogue does not need to be copied for each call. Cloning
+ * the view is O(1), since only the reference to the snapshot is copied.
+ */
+class DoocsBackendRegisterCatalogueView : public ChimeraTK::BackendRegisterCatalogueBase {
+ public:
+  explicit DoocsBackendRegisterCatalogueView(std::shared_ptr<const DoocsBackendRegisterCatalogue> catalogue);
+
+  [[nodiscard]] ChimeraTK::RegisterInfo getRegister(const ChimeraTK::RegisterPath& registerPathName) const override;
+
+  [[nodiscard]] bool hasRegister(const ChimeraTK::RegisterPath& registerPathName) const override;
+
+  [[nodiscard]] size_t getNumberOfRegisters() const override;
+
+  [[nodiscard]] std::unique_ptr<ChimeraTK::const_RegisterCatalogueImplIterator> getConstIteratorBegin() const override;
+
+  [[nodiscard]] std::unique_ptr<ChimeraTK::const_RegisterCatalogueImplIterator> getConstIteratorEnd() const override;
+
+  [[nodiscard]] std::unique_ptr<ChimeraTK::BackendRegisterCatalogueBase> clone() const override;
+
+ private:
+  std::shared_ptr<const DoocsBackendRegisterCatalogue> _catalogue;
 };
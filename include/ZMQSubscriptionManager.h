@@ -1,6 +1,10 @@
 #ifndef CHIMERATK_DOOCS_BACKEND_ZMQSUBSCRIPTIONMANAGER_H
 #define CHIMERATK_DOOCS_BACKEND_ZMQSUBSCRIPTIONMANAGER_H
 
+#include "DoocsBackendEqDataPool.h"
+#include "DoocsBackendLatencyTracing.h"
+#include "DoocsBackendSpscRing.h"
+
 #include <ChimeraTK/Exception.h>
 
 #include <boost/shared_ptr.hpp>
@@ -8,9 +12,13 @@
 #include <eq_fct.h>
 #include <pthread.h>
 
+#include <atomic>
+#include <condition_variable>
+#include <deque>
 #include <map>
 #include <mutex>
 #include <string>
+#include <thread>
 #include <vector>
 
 namespace ChimeraTK {
@@ -43,6 +51,9 @@ namespace ChimeraTK {
       /// DoocsBackend::setException().
       void deactivateAllListenersAndPushException(DoocsBackend* backend, const std::string& message);
 
+      /// Number of updates which can be handed off by the DOOCS thread to the decoding workers per subscription
+      static constexpr size_t handOffCapacity = 64;
+
      private:
       ZMQSubscriptionManager();
       ~ZMQSubscriptionManager();
@@ -64,6 +75,14 @@ namespace ChimeraTK {
       bool dmsgStartCalled{false};
       std::mutex dmsgStartCalled_mutex;
 
+      class DecodingWorker;
+
+      /// Update received by zmq_callback(), handed off to a decoding worker
+      struct ReceivedUpdate {
+        DoocsBackendEqDataPool::Handle data;
+        NotificationTrace trace;
+      };
+
       /// Structure describing a single subscription
       struct Subscription {
         Subscription() : zqmThreadId(ZMQSubscriptionManager::pthread_t_invalid) {}
@@ -87,8 +106,9 @@ namespace ChimeraTK {
         bool active{false};
 
         /// Flag whether the callback function has already been called for this subscription, with a condition variable
-        /// for the notification when the callback is called for the first time.
-        bool started{false};
+        /// for the notification when the callback is called for the first time. Written only while holding the
+        /// listeners_mutex, but read without lock by the callback to skip the lock when handing off updates.
+        std::atomic<bool> started{false};
         std::condition_variable startedCv{};
 
         /// Set when the first non-error value is received by the callback function. Will be cleared again when the
@@ -98,8 +118,92 @@ namespace ChimeraTK {
         /// exception state of the backend and its recovery!
         /// Access requires holding the listeners_mutex.
         bool gotInitialValue{false};
+
+        /// Buffers for the updates pushed into the notification queues of the listeners, shared by all listeners (see
+        /// DoocsBackendEqDataPool). Created by the first subscribe(), the number of buffers kept follows the number of
+        /// listeners (see updatePoolSize()). Access requires holding the listeners_mutex.
+        std::shared_ptr<DoocsBackendEqDataPool> pool;
+
+        /// Whether any listener belongs to a backend with latency tracing, so the callback takes the time stamps. Set
+        /// by updateListenerFlags() while holding the listeners_mutex, read by the callback without lock.
+        std::atomic<bool> tracing{false};
+
+        /// Whether any listener belongs to a backend with settings for the ZeroMQ thread (see DoocsBackend CDD
+        /// parameters zmqCpus etc.). Set by updateListenerFlags() like tracing.
+        std::atomic<bool> hasThreadSettings{false};
+
+        /// Set once a listener of a backend with decoding workers (CDD parameter zmqWorkers) has subscribed. The
+        /// callback then only copies the update into a buffer of the receivePool and hands it off through the ring to
+        /// the decoding worker, which distributes it to the listeners. Never cleared, so the order of the updates is
+        /// kept. worker and receivePool are set before and must not be changed afterwards.
+        std::atomic<bool> offload{false};
+        DecodingWorker* worker{nullptr};
+        std::shared_ptr<DoocsBackendEqDataPool> receivePool;
+        DoocsBackendSpscRing<ReceivedUpdate, handOffCapacity> ring;
+
+        /// Set while the subscription is queued at its worker
+        std::atomic<bool> scheduled{false};
+
+        /// Number of updates replaced in the overflow slot of the ring because the worker could not keep up, recorded
+        /// in the statistics by the worker
+        std::atomic<size_t> dropped{0};
+      };
+
+      /// Thread distributing the updates handed off by the callback for its subscriptions
+      class DecodingWorker {
+       public:
+        DecodingWorker();
+        ~DecodingWorker();
+
+        /// Queue the subscription for processing its ring, unless already queued. Called by the callback.
+        void schedule(Subscription* subscription);
+
+        /// Remove subscription from the queue and wait until it is no longer processed. The callback must no longer be
+        /// called for the subscription.
+        void cancel(Subscription* subscription);
+
+       private:
+        void run();
+
+        std::mutex mutex;
+        std::condition_variable cv;
+        /// notified when the processing of a subscription is complete (for cancel())
+        std::condition_variable doneCv;
+        std::deque<Subscription*> ready;
+        Subscription* current{nullptr};
+        bool stop{false};
+        std::thread thread;
       };
 
+      /// Hand off the update to the decoding worker of the subscription. Called by the callback.
+      static void handOff(Subscription& subscription, doocs::EqData& data, const NotificationTrace& trace);
+
+      /// Process the updates in the ring of the subscription. Called by the decoding worker.
+      static void processHandedOff(Subscription& subscription);
+
+      /// Push the update (data or error) to the listeners of the subscription. The listeners_mutex must be held through
+      /// the given lock, which is temporarily released when reporting errors to the backends.
+      static void distribute(Subscription& subscription, doocs::EqData& data, const NotificationTrace& trace,
+          std::unique_lock<std::mutex>& lock);
+
+      /// Enable the hand off for the subscription, starting the decoding workers if needed. subscriptionMap_mutex and
+      /// listeners_mutex must be held.
+      void enableOffload(Subscription& subscription, size_t nWorkers);
+
+      /// Adapt the number of buffers kept by the pool of the subscription to its listeners: one per slot of each
+      /// notification queue (including the one being written), one being filled by the callback and one for the initial
+      /// value poll. listeners_mutex must be held.
+      static void updatePoolSize(Subscription& subscription);
+
+      /// Update Subscription::tracing and hasThreadSettings after the listeners have changed. listeners_mutex must be
+      /// held.
+      static void updateListenerFlags(Subscription& subscription);
+
+      /// decoding workers, created on demand with the largest number requested by a backend. Subscriptions are
+      /// assigned round robin, each subscription always uses the same worker.
+      std::vector<std::unique_ptr<DecodingWorker>> workers;
+      size_t nextWorker{0};
+
       /// A "random" value of pthread_t which we consider "invalid" in context of Subscription::zqmThreadId. Technically
       /// we use a valid pthread_t of a thread which cannot be a ZeroMQ subscription thread. All values of
       /// Subscription::zqmThreadId will be initialised with this value.
@@ -128,10 +128,17 @@ namespace Cache {
       }
     }
 
-    bool is_ifff = (doocsTypeId == DATA_IFFF);
+    // The meta data registers are written to the file as well, but they have already been added together with their
+    // property. Real properties with the names "eventId" or "timeStamp" are not affected.
+    if(catalogue.hasRegister(name)) {
+      auto field = catalogue.getBackendRegister(name)._field;
+      if(field == DoocsBackendRegisterInfo::Field::eventId || field == DoocsBackendRegisterInfo::Field::timeStamp) {
+        return;
+      }
+    }
 
-    if(is_ifff) {
-      auto pattern = detail::endsWith(name, {"/I", "/F1", "/F2", "/F3"}).second;
+    if(doocsTypeId == DATA_IFFF || doocsTypeId == DATA_USTR) {
+      auto pattern = detail::endsWith(name, {"/I", "/F1", "/F2", "/F3", "/TM", "/STR"}).second;
       // remove pattern from name for getRegInfo to work correctly;
       // precondition: patten is contained in name.
       name.erase(name.end() - pattern.length(), name.end());
@@ -229,7 +236,7 @@ namespace Cache {
     lengthTag->set_child_text(std::to_string(r.getNumberOfElements()));
 
     auto accessMode = registerTag->add_child("access_mode");
-    accessMode->set_child_text(r.accessModeFlags.serialize());
+    accessMode->set_child_text(r.getSupportedAccessModes().serialize());
 
     auto typeId = registerTag->add_child("doocs_type_id");
     typeId->set_child_text(std::to_string(r.doocsTypeId));
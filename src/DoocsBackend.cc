@@ -14,8 +14,11 @@
 #include "DoocsBackendIIIIRegisterAccessor.h"
 #include "DoocsBackendImageRegisterAccessor.h"
 #include "DoocsBackendNumericRegisterAccessor.h"
+#include "DoocsBackendStatisticsAccessor.h"
 #include "DoocsBackendStringRegisterAccessor.h"
+#include "DoocsBackendTimedRpc.h"
 #include "DoocsBackendTimeStampAccessor.h"
+#include "DoocsBackendUSTRRegisterAccessor.h"
 #include "RegisterInfo.h"
 #include "StringUtility.h"
 #include "ZMQSubscriptionManager.h"
@@ -81,11 +84,29 @@ namespace ChimeraTK {
   /********************************************************************************************************************/
 
   DoocsBackend::DoocsBackend(const std::string& serverAddress, const std::string& cacheFile,
-      const std::string& updateCache, const std::string& dataConsistencyRealmName)
-  : _serverAddress(serverAddress), _cacheFile(cacheFile) {
+      const std::string& updateCache, const std::string& dataConsistencyRealmName, bool enableStatistics,
+      bool enableLatencyTracing, const std::string& traceFile, bool enableAsyncWrite, std::chrono::milliseconds rmwMaxAge,
+      std::chrono::milliseconds recoveryProbeTimeout, std::chrono::milliseconds rpcTimeout,
+      std::chrono::milliseconds pollPeriod, DoocsBackendThreadSettings zmqThreadSettings, size_t zmqWorkers,
+      bool convertOnReceive, size_t pollThreads)
+  : _serverAddress(serverAddress), _snapshotCache(rmwMaxAge), _rpcTimeout(rpcTimeout),
+    _zmqThreadSettings(std::move(zmqThreadSettings)), _zmqWorkers(zmqWorkers), _convertOnReceive(convertOnReceive),
+    _cacheFile(cacheFile), _statisticsEnabled(enableStatistics), _traceFile(traceFile),
+    _recoveryProbeTimeout(recoveryProbeTimeout) {
+    if(enableLatencyTracing || !_traceFile.empty()) {
+      _latencyTracer.enable();
+    }
+    if(enableAsyncWrite) {
+      _asyncWriter = std::make_unique<DoocsBackendAsyncWriter>(*this);
+    }
+    if(pollPeriod.count() > 0) {
+      _pollScheduler = std::make_unique<DoocsBackendPollScheduler>(*this, pollPeriod, pollThreads);
+    }
+
+    _catalogue = makeCatalogueSnapshot({});
     if(cacheFileExists() && isCachingEnabled()) {
       // provide catalogue immediately from cache
-      catalogue = Cache::readCatalogue(_cacheFile);
+      _catalogue = makeCatalogueSnapshot(Cache::readCatalogue(_cacheFile));
       _catalogueFromCache = true;
 
       // update cache file in the background
@@ -105,6 +126,7 @@ namespace ChimeraTK {
     doocs::zmq_set_subscription_timeout(10);
 
     _dataConsistencyRealm = async::DataConsistencyRealmStore::getInstance().getRealm(dataConsistencyRealmName);
+    _versionCache = std::make_unique<DoocsBackendVersionCache>(_dataConsistencyRealm);
 
     FILL_VIRTUAL_FUNCTION_TEMPLATE_VTABLE(getRegisterAccessor_impl);
   }
@@ -112,6 +134,10 @@ namespace ChimeraTK {
   /********************************************************************************************************************/
 
   DoocsBackend::~DoocsBackend() {
+    // stop the sender and polling threads first, they report errors to this backend
+    _asyncWriter.reset();
+    _pollScheduler.reset();
+    writeTraceFile();
     if(_catalogueFuture.valid()) {
       try {
         _cancelFlag.set_value(); // cancel fill catalogue async task
@@ -167,15 +193,107 @@ namespace ChimeraTK {
       dataConsistencyRealmName = parameters.at("dataConsistencyRealmName");
     }
 
+    bool enableStatistics = parameters["statistics"] == "1";
+    bool enableLatencyTracing = parameters["latencyTracing"] == "1";
+    std::string traceFile = parameters["traceFile"];
+    bool enableAsyncWrite = parameters["asyncWrite"] == "1";
+    bool convertOnReceive = parameters["convertOnReceive"] == "1";
+
+    auto getMilliseconds = [&](const std::string& name) {
+      std::chrono::milliseconds value{0};
+      if(!parameters[name].empty()) {
+        try {
+          value = std::chrono::milliseconds(std::stol(parameters[name]));
+        }
+        catch(std::exception&) {
+          throw ChimeraTK::logic_error("DoocsBackend: invalid value for parameter " + name + ": " + parameters[name]);
+        }
+      }
+      return value;
+    };
+    auto rmwMaxAge = getMilliseconds("rmwMaxAge");
+    auto recoveryProbeTimeout = getMilliseconds("recoveryProbe");
+    auto rpcTimeout = getMilliseconds("rpcTimeoutMs");
+    auto pollPeriod = getMilliseconds("pollPeriod");
+    auto zmqThreadSettings = DoocsBackendThreadSettings::parse(
+        parameters["zmqCpus"], parameters["zmqSchedPolicy"], parameters["zmqPriority"]);
+    auto getCount = [&](const std::string& name, size_t defaultValue) {
+      size_t value = defaultValue;
+      if(!parameters[name].empty()) {
+        try {
+          if(parameters[name][0] == '-') throw std::invalid_argument("negative");
+          value = std::stoul(parameters[name]);
+        }
+        catch(std::exception&) {
+          throw ChimeraTK::logic_error("DoocsBackend: invalid value for parameter " + name + ": " + parameters[name]);
+        }
+      }
+      return value;
+    };
+    size_t zmqWorkers = getCount("zmqWorkers", 0);
+    size_t pollThreads = getCount("pollThreads", DoocsBackendPollScheduler::defaultMaxThreads);
+    if(pollThreads == 0) {
+      throw ChimeraTK::logic_error("DoocsBackend: invalid value for parameter pollThreads: 0");
+    }
+
     // create and return the backend
-    return boost::shared_ptr<DeviceBackend>(
-        new DoocsBackend(address, cacheFile, updateCache, dataConsistencyRealmName));
+    return boost::shared_ptr<DeviceBackend>(new DoocsBackend(address, cacheFile, updateCache, dataConsistencyRealmName,
+        enableStatistics, enableLatencyTracing, traceFile, enableAsyncWrite, rmwMaxAge, recoveryProbeTimeout,
+        rpcTimeout, pollPeriod, std::move(zmqThreadSettings), zmqWorkers, convertOnReceive, pollThreads));
+  }
+
+  /********************************************************************************************************************/
+
+  std::vector<DoocsBackend::ConnectionProbe> DoocsBackend::probeConnections() {
+    std::vector<ConnectionProbe> probes;
+    for(auto& address : _addressCache.getLocationAddresses()) {
+      // The workers must not access the backend, which might be gone by the time the call returns.
+      probes.push_back({address, DoocsBackendTimedRpc::getAsync(address, _addressCache.get(address))});
+    }
+    return probes;
+  }
+
+  /********************************************************************************************************************/
+
+  std::string DoocsBackend::evaluateConnectionProbes(std::vector<ConnectionProbe>& probes) {
+    bool probeEnabled = _recoveryProbeTimeout.count() > 0;
+    auto deadline = std::chrono::steady_clock::now() + (probeEnabled ? _recoveryProbeTimeout : prewarmWaitTime);
+    std::string message;
+    for(auto& probe : probes) {
+      if(probe.result.wait_until(deadline) != std::future_status::ready) {
+        if(probeEnabled && message.empty()) {
+          lastFailedAddress = probe.address;
+          message = std::format("Cannot read from DOOCS property '{}': no response within {} ms", probe.address,
+              _recoveryProbeTimeout.count());
+        }
+        continue;
+      }
+      auto result = probe.result.get();
+      bool success = result.rc != doocs::TransactionResult::transaction_error &&
+          result.rc != doocs::TransactionResult::transport_error;
+      _statistics.recordRead(result.latency, success);
+      if(success) {
+        _addressCache.update(probe.address, result.ea);
+      }
+      else if(probeEnabled && message.empty()) {
+        lastFailedAddress = probe.address;
+        message = std::format("Cannot read from DOOCS property '{}': {}", probe.address, result.message);
+      }
+    }
+    return message;
   }
 
   /********************************************************************************************************************/
 
   void DoocsBackend::open() {
+    // Connect to the locations of existing accessors in the background while checking for recovery
+    auto probes = probeConnections();
+
     std::unique_lock<std::mutex> lk(_mxRecovery);
+    if(_recoveryProbeTimeout.count() > 0 && !_addressCache.isRegistered(lastFailedAddress)) {
+      // the accessor has been destroyed, and the probes check the locations of all remaining accessors
+      lastFailedAddress = "";
+    }
     if(lastFailedAddress != "") {
       // Check if the backend is already in the exception state. If so, obtain the stored exception
       // message to use as a stable error message in case the recovery check fails again.
@@ -184,30 +302,41 @@ namespace ChimeraTK {
         storedExceptionMessage = getActiveExceptionMessage();
       }
       // open() is called after a runtime_error: check if device is recovered.
-      doocs::EqAdr ea;
-      ea.adr(lastFailedAddress);
-      EqCall eq;
+      auto ea = _addressCache.get(lastFailedAddress);
+      DoocsBackendTimedRpc eq(lastFailedAddress);
       doocs::EqData src, dst;
-      int rc = eq.get(&ea, &src, &dst);
+      int rc = eq.get(&ea, &src, &dst, _rpcTimeout);
       // if again error received, throw exception
       if(rc == doocs::TransactionResult::transaction_error || rc == doocs::TransactionResult::transport_error) {
         lk.unlock();
         // Use the stored exception message if available to ensure stable error messages
         // during recovery attempts, avoiding oscillation between different DOOCS error texts.
         auto message = storedExceptionMessage.empty() || storedExceptionMessage == "(exception cleared)" ?
-            std::format("Cannot read from DOOCS property '{}': {}", lastFailedAddress, dst.get_string()) :
+            std::format("Cannot read from DOOCS property '{}': {}", lastFailedAddress, eq.getErrorMessage(dst)) :
             storedExceptionMessage;
         setException(message);
         throw ChimeraTK::runtime_error(message);
       }
+      _addressCache.update(lastFailedAddress, ea);
       lastFailedAddress = "";
     }
-    _startVersion = {};
+
+    // Wait for the connections to all locations. With the recovery probe enabled, all locations must respond within
+    // the probe timeout, so a partial outage is detected here instead of by the first failing transfer.
+    auto message = evaluateConnectionProbes(probes);
+    if(!message.empty()) {
+      lk.unlock();
+      setException(message);
+      throw ChimeraTK::runtime_error(message);
+    }
+
+    _startVersion.store(std::make_shared<const VersionNumber>(), std::memory_order_release);
     setOpenedAndClearException();
 
     // re-trigger catalogue filling? Only done if catalogue is not taken from cache, is not currently begin fetched, and
     // the catalogue is incomplete.
-    if(!_catalogueFromCache && !_catalogueFuture.valid() && !catalogue.isComplete()) {
+    std::lock_guard<std::mutex> lkCatalogue(_mxCatalogue);
+    if(!_catalogueFromCache && !_catalogueFuture.valid() && !_catalogue->isComplete()) {
       _cancelFlag = std::promise<void>{};
       _catalogueFuture =
           std::async(std::launch::async, fetchCatalogue, _serverAddress, _cacheFile, _cancelFlag.get_future());
@@ -217,34 +346,75 @@ namespace ChimeraTK {
   /********************************************************************************************************************/
 
   RegisterCatalogue DoocsBackend::getRegisterCatalogue() const {
-    return RegisterCatalogue(getBackendRegisterCatalogue().clone());
+    // hand out a view onto the shared snapshot instead of a deep copy
+    return RegisterCatalogue(std::make_unique<DoocsBackendRegisterCatalogueView>(getBackendRegisterCatalogue()));
   }
 
   /********************************************************************************************************************/
 
-  const DoocsBackendRegisterCatalogue& DoocsBackend::getBackendRegisterCatalogue() const {
+  std::shared_ptr<const DoocsBackendRegisterCatalogue> DoocsBackend::getBackendRegisterCatalogue() const {
+    std::lock_guard<std::mutex> lk(_mxCatalogue);
     if(_catalogueFuture.valid()) {
-      catalogue = _catalogueFuture.get();
+      // replace the snapshot, catalogues handed out before keep the old one
+      _catalogue = makeCatalogueSnapshot(_catalogueFuture.get());
     }
-    return catalogue;
+    return _catalogue;
+  }
+
+  /********************************************************************************************************************/
+
+  std::shared_ptr<const DoocsBackendRegisterCatalogue> DoocsBackend::makeCatalogueSnapshot(
+      DoocsBackendRegisterCatalogue&& catalogue) const {
+    if(_statisticsEnabled) {
+      std::string prefix = std::string(DoocsBackendStatistics::registerPrefix) + "/";
+      for(const auto& name : DoocsBackendStatistics::getScalarRegisterNames()) {
+        catalogue.addBackendRegister(prefix + name, 1, DATA_LONG);
+      }
+      for(const auto& name : DoocsBackendStatistics::getArrayRegisterNames()) {
+        catalogue.addBackendRegister(prefix + name, DoocsBackendStatistics::nBuckets, DATA_A_LONG);
+      }
+    }
+    return std::make_shared<const DoocsBackendRegisterCatalogue>(std::move(catalogue));
   }
 
   /********************************************************************************************************************/
 
   void DoocsBackend::close() {
+    if(_asyncWriter) {
+      _asyncWriter->flush();
+    }
     DoocsBackendNamespace::ZMQSubscriptionManager::getInstance().deactivateAllListeners(this);
+    if(_pollScheduler) {
+      _pollScheduler->deactivate();
+    }
     _opened = false;
     _asyncReadActivated = false;
+    _snapshotCache.clear();
     {
       std::unique_lock<std::mutex> lk(_mxRecovery);
 
       lastFailedAddress = "";
     }
+    writeTraceFile();
+  }
+
+  /********************************************************************************************************************/
+
+  void DoocsBackend::writeTraceFile() const noexcept {
+    if(_traceFile.empty()) return;
+    try {
+      _latencyTracer.writeChromeTrace(_traceFile);
+    }
+    catch(ChimeraTK::runtime_error& e) {
+      std::cerr << "DoocsBackend: " << e.what() << std::endl;
+    }
   }
 
   /********************************************************************************************************************/
 
   void DoocsBackend::informRuntimeError(const std::string& address) {
+    // the server might have moved, resolve the address again after recovery
+    _addressCache.invalidate(address);
     std::lock_guard<std::mutex> lk(_mxRecovery);
     if(lastFailedAddress == "") {
       lastFailedAddress = address;
@@ -255,6 +425,11 @@ namespace ChimeraTK {
 
   void DoocsBackend::setExceptionImpl() noexcept {
     _asyncReadActivated = false;
+    if(_asyncWriter) {
+      // values written before the exception must not be sent after recovery
+      _asyncWriter->discard();
+    }
+    _snapshotCache.clear();
     std::string message{"Unknown exception reported by another accessor"};
     try {
       checkActiveException();
@@ -263,6 +438,9 @@ namespace ChimeraTK {
       message = e.what();
     }
     DoocsBackendNamespace::ZMQSubscriptionManager::getInstance().deactivateAllListenersAndPushException(this, message);
+    if(_pollScheduler) {
+      _pollScheduler->deactivateAndPushException(message);
+    }
   }
 
   /********************************************************************************************************************/
@@ -278,6 +456,9 @@ namespace ChimeraTK {
     }
 
     DoocsBackendNamespace::ZMQSubscriptionManager::getInstance().activateAllListeners(this);
+    if(_pollScheduler) {
+      _pollScheduler->activate();
+    }
   }
 
   /********************************************************************************************************************/
@@ -286,6 +467,22 @@ namespace ChimeraTK {
   boost::shared_ptr<NDRegisterAccessor<UserType>> DoocsBackend::getRegisterAccessor_impl(
       const RegisterPath& registerPathName, size_t numberOfWords, size_t wordOffsetInRegister, AccessModeFlags flags) {
     boost::shared_ptr<NDRegisterAccessor<UserType>> p;
+
+    // statistics registers are provided by the backend itself
+    std::string statisticsPrefix = std::string(DoocsBackendStatistics::registerPrefix) + "/";
+    if(boost::starts_with(std::string(registerPathName), statisticsPrefix)) {
+      if(!_statisticsEnabled) {
+        throw ChimeraTK::logic_error("Statistics registers are not enabled, use the CDD parameter statistics=1 to "
+                                     "access register '" +
+            registerPathName + "'.");
+      }
+      p = boost::make_shared<DoocsBackendStatisticsAccessor<UserType>>(
+          boost::static_pointer_cast<DoocsBackend>(shared_from_this()), registerPathName,
+          std::string(registerPathName).substr(statisticsPrefix.size()), numberOfWords, wordOffsetInRegister, flags);
+      p->setExceptionBackend(shared_from_this());
+      return p;
+    }
+
     std::string path = _serverAddress + registerPathName;
 
     // check for additional hierarchy level, which indicates an access to a field of a complex property data type
@@ -319,20 +516,20 @@ namespace ChimeraTK {
 
     // if backend is open, read property once to obtain type
     int doocsTypeId = DATA_NULL;
+    auto ea = _addressCache.get(path);
     if(isOpen()) {
-      doocs::EqAdr ea;
-      EqCall eq;
+      DoocsBackendTimedRpc eq(path);
       doocs::EqData src, dst;
-      ea.adr(path);
-      int rc = eq.get(&ea, &src, &dst);
+      int rc = eq.get(&ea, &src, &dst, _rpcTimeout);
       if(!rc) {
         doocsTypeId = dst.type();
+        _addressCache.update(path, ea);
       }
     }
 
     // if backend is closed, or if property could not be read, use the (potentially cached) catalogue
     if(doocsTypeId == DATA_NULL) {
-      auto reg = getBackendRegisterCatalogue().getBackendRegister(registerPathName);
+      auto reg = getBackendRegisterCatalogue()->getBackendRegister(registerPathName);
       doocsTypeId = reg.doocsTypeId;
     }
 
@@ -370,6 +567,7 @@ namespace ChimeraTK {
         case DATA_A_FLOAT:
         case DATA_DOUBLE:
         case DATA_A_DOUBLE:
+        case DATA_A_BYTE:
           p.reset(new DoocsBackendNumericRegisterAccessor<UserType>(
               sharedThis, path, registerPathName, numberOfWords, wordOffsetInRegister, flags));
           break;
@@ -389,6 +587,16 @@ namespace ChimeraTK {
               sharedThis, path, field, registerPathName, numberOfWords, wordOffsetInRegister, flags));
           break;
 
+        case DATA_USTR:
+          if(!hasExtraLevel) {
+            throw ChimeraTK::logic_error("DOOCS property of USTR type '" + _serverAddress + registerPathName +
+                "' cannot be accessed as a whole.");
+          }
+          extraLevelUsed = true;
+          p.reset(new DoocsBackendUSTRRegisterAccessor<UserType>(
+              sharedThis, path, field, registerPathName, numberOfWords, wordOffsetInRegister, flags));
+          break;
+
         case DATA_TEXT:
         case DATA_STRING:
           p.reset(new DoocsBackendStringRegisterAccessor<UserType>(
@@ -0,0 +1,138 @@
+// SPDX-FileCopyrightText: Deutsches Elektronen-Synchrotron DESY, MSK, ChimeraTK Project <chimeratk-support@desy.de>
+// SPDX-License-Identifier: LGPL-3.0-or-later
+
+#include "DoocsBackendAsyncWriter.h"
+
+#include "DoocsBackend.h"
+#include "DoocsBackendTimedRpc.h"
+
+#include <eq_errors.h>
+
+#include <chrono>
+#include <iostream>
+
+namespace ChimeraTK {
+
+  /********************************************************************************************************************/
+
+  DoocsBackendAsyncWriter::DoocsBackendAsyncWriter(DoocsBackend& backend) : _backend(backend) {
+    _thread = std::thread([this] { run(); });
+  }
+
+  /********************************************************************************************************************/
+
+  DoocsBackendAsyncWriter::~DoocsBackendAsyncWriter() {
+    {
+      std::lock_guard<std::mutex> lk(_mx);
+      _stop = true;
+    }
+    _cvWork.notify_all();
+    _thread.join();
+  }
+
+  /********************************************************************************************************************/
+
+  bool DoocsBackendAsyncWriter::enqueue(const std::string& address, const doocs::EqData& data) {
+    bool coalesced;
+    {
+      std::lock_guard<std::mutex> lk(_mx);
+      auto [it, inserted] = _pending.try_emplace(address);
+      it->second = data;
+      coalesced = !inserted;
+      if(inserted) {
+        _order.push_back(address);
+        // subscription updates must not replace the snapshot of the value until it has been sent
+        _backend._snapshotCache.beginWrite(address);
+      }
+    }
+    if(coalesced) {
+      _backend._statistics.recordAsyncWriteCoalesced();
+    }
+    _cvWork.notify_one();
+    return coalesced;
+  }
+
+  /********************************************************************************************************************/
+
+  bool DoocsBackendAsyncWriter::isPending(const std::string& address) const {
+    if(address.empty()) {
+      return !_pending.empty() || !_inFlight.empty();
+    }
+    return _pending.count(address) || _inFlight == address;
+  }
+
+  /********************************************************************************************************************/
+
+  void DoocsBackendAsyncWriter::flush(const std::string& address) {
+    std::unique_lock<std::mutex> lk(_mx);
+    _cvDone.wait(lk, [&] { return _stop || !isPending(address); });
+  }
+
+  /********************************************************************************************************************/
+
+  void DoocsBackendAsyncWriter::discard() {
+    {
+      std::lock_guard<std::mutex> lk(_mx);
+      for(auto& [address, data] : _pending) {
+        _backend._snapshotCache.endWrite(address, false);
+      }
+      _pending.clear();
+      _order.clear();
+    }
+    _cvDone.notify_all();
+  }
+
+  /********************************************************************************************************************/
+
+  void DoocsBackendAsyncWriter::run() {
+    doocs::EqAdr ea;
+    doocs::EqData src, dst;
+
+    std::unique_lock<std::mutex> lk(_mx);
+    while(true) {
+      _cvWork.wait(lk, [&] { return _stop || !_order.empty(); });
+      if(_stop) {
+        break;
+      }
+
+      // take the oldest address with its latest value
+      _inFlight = std::move(_order.front());
+      _order.pop_front();
+      auto it = _pending.find(_inFlight);
+      src = std::move(it->second);
+      _pending.erase(it);
+      lk.unlock();
+
+      ea = _backend._addressCache.get(_inFlight);
+      DoocsBackendTimedRpc eq(_inFlight);
+      auto start = std::chrono::steady_clock::now();
+      int rc = eq.set(&ea, &src, &dst, _backend._rpcTimeout);
+      bool readOnly = !eq.hasTimedOut() && dst.error() == eq_errors::read_only;
+      bool failed =
+          rc == doocs::TransactionResult::transaction_error || rc == doocs::TransactionResult::transport_error || readOnly;
+      _backend._statistics.recordWrite(std::chrono::steady_clock::now() - start, !failed);
+      if(eq.hasTimedOut()) _backend._statistics.recordTimeout();
+      _backend._snapshotCache.endWrite(_inFlight, !failed);
+      if(readOnly) {
+        // Not a communication error, so there is nothing to recover. The accessors of the address become read-only
+        // with their next write (see DoocsBackendRegisterAccessor::doPreWrite()).
+        _backend._addressCache.markReadOnly(_inFlight);
+        std::cerr << "DoocsBackend: cannot write to read-only DOOCS property '" << _inFlight << "'" << std::endl;
+      }
+      else if(failed) {
+        // the accessor has already returned from write(), so report through the backend exception state
+        _backend.informRuntimeError(_inFlight);
+        _backend.setException(std::string("Cannot write to DOOCS property: ") + eq.getErrorMessage(dst));
+      }
+
+      lk.lock();
+      _inFlight.clear();
+      _cvDone.notify_all();
+    }
+    _inFlight.clear();
+    _cvDone.notify_all();
+  }
+
+  /********************************************************************************************************************/
+
+} // namespace ChimeraTK
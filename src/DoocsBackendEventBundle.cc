@@ -0,0 +1,162 @@
+// SPDX-FileCopyrightText: Deutsches Elektronen-Synchrotron DESY, MSK, ChimeraTK Project <chimeratk-support@desy.de>
+// SPDX-License-Identifier: LGPL-3.0-or-later
+
+#include "DoocsBackendEventBundle.h"
+
+#include <algorithm>
+
+namespace ChimeraTK {
+
+  /********************************************************************************************************************/
+
+  std::shared_ptr<DoocsBackendEventBundle> DoocsBackendEventBundle::create(size_t window) {
+    if(window == 0) {
+      throw ChimeraTK::logic_error("DoocsBackendEventBundle: the window must not be 0.");
+    }
+    // constructor is private to enforce the use of shared_ptr (the accessors keep a reference to the bundle)
+    return std::shared_ptr<DoocsBackendEventBundle>(new DoocsBackendEventBundle(window));
+  }
+
+  /********************************************************************************************************************/
+
+  void DoocsBackendEventBundle::add(TransferElementAbstractor& accessor) {
+    if(!accessor.getAccessModeFlags().has(AccessMode::wait_for_new_data)) {
+      throw ChimeraTK::logic_error("DoocsBackendEventBundle: accessor '" + accessor.getName() +
+          "' does not use AccessMode::wait_for_new_data.");
+    }
+    auto elements = accessor.getHardwareAccessingElements();
+    DoocsBackendRegisterAccessorBase* member = nullptr;
+    if(elements.size() == 1) {
+      member = dynamic_cast<DoocsBackendRegisterAccessorBase*>(elements.front().get());
+    }
+    if(!member || !member->useZMQ || member->usePolling) {
+      throw ChimeraTK::logic_error(
+          "DoocsBackendEventBundle: accessor '" + accessor.getName() + "' is not a ZeroMQ accessor of the DoocsBackend.");
+    }
+
+    std::lock_guard<std::mutex> lk(_mx);
+    if(member->_bundle) {
+      throw ChimeraTK::logic_error(
+          "DoocsBackendEventBundle: accessor '" + accessor.getName() + "' already belongs to a bundle.");
+    }
+    member->_bundle = shared_from_this();
+    _members.push_back(member);
+    _elements.emplace_back(accessor.getHighLevelImplElement());
+
+    // pending sets can no longer be completed with the old number of members
+    _pending.clear();
+  }
+
+  /********************************************************************************************************************/
+
+  void DoocsBackendEventBundle::read() {
+    std::vector<boost::shared_ptr<TransferElement>> elements;
+    {
+      std::lock_guard<std::mutex> lk(_mx);
+      for(auto& weak : _elements) {
+        auto element = weak.lock();
+        if(!element) {
+          throw ChimeraTK::logic_error("DoocsBackendEventBundle: read() called after an accessor has been destroyed.");
+        }
+        elements.push_back(std::move(element));
+      }
+    }
+    if(elements.empty()) {
+      throw ChimeraTK::logic_error("DoocsBackendEventBundle: read() called on an empty bundle.");
+    }
+    for(auto& element : elements) {
+      element->read();
+    }
+  }
+
+  /********************************************************************************************************************/
+
+  void DoocsBackendEventBundle::push(DoocsBackendRegisterAccessorBase* accessor, DoocsBackendNotification&& notification) {
+    auto eventId = notification.data->get_event_id();
+    if(eventId == doocs::EventId()) {
+      // cannot be aligned
+      accessor->notifications.push_overwrite(std::move(notification));
+      return;
+    }
+
+    std::unique_lock<std::mutex> lk(_mx);
+    if(!(_lastEventId < eventId)) {
+      // the set for this eventId has already been delivered or dropped
+      return;
+    }
+    auto index = size_t(std::find(_members.begin(), _members.end(), accessor) - _members.begin());
+    if(index >= _members.size()) {
+      return;
+    }
+
+    auto& set = _pending[eventId];
+    if(set.updates.empty()) {
+      set.updates.resize(_members.size());
+    }
+    if(!set.updates[index]) {
+      ++set.nReceived;
+    }
+    set.updates[index] = std::move(notification);
+
+    if(set.nReceived < _members.size()) {
+      // keep the number of pending eventIds within the window
+      while(_pending.size() > _window) {
+        dropOldest();
+      }
+      return;
+    }
+
+    // set complete: older incomplete sets cannot be completed any more
+    while(_pending.begin()->first != eventId) {
+      dropOldest();
+    }
+    auto complete = std::move(_pending.begin()->second);
+    _pending.erase(_pending.begin());
+    _lastEventId = eventId;
+
+    for(size_t i = 0; i < _members.size(); ++i) {
+      // don't push data after an exception until the listener is activated again (see ZMQSubscriptionManager)
+      if(!_members[i]->isActiveZMQ) continue;
+      _members[i]->notifications.push_overwrite(std::move(*complete.updates[i]));
+    }
+  }
+
+  /********************************************************************************************************************/
+
+  void DoocsBackendEventBundle::remove(DoocsBackendRegisterAccessorBase* accessor) {
+    std::lock_guard<std::mutex> lk(_mx);
+    auto it = std::find(_members.begin(), _members.end(), accessor);
+    if(it == _members.end()) return;
+    auto index = size_t(it - _members.begin());
+    _members.erase(it);
+    _elements.erase(_elements.begin() + std::ptrdiff_t(index));
+    _pending.clear();
+  }
+
+  /********************************************************************************************************************/
+
+  void DoocsBackendEventBundle::reset() {
+    std::lock_guard<std::mutex> lk(_mx);
+    _pending.clear();
+    _lastEventId = doocs::EventId();
+  }
+
+  /********************************************************************************************************************/
+
+  void DoocsBackendRegisterAccessorBase::leaveBundle() {
+    if(!_bundle) return;
+    _bundle->remove(this);
+    _bundle.reset();
+  }
+
+  /********************************************************************************************************************/
+
+  void DoocsBackendEventBundle::dropOldest() {
+    _lastEventId = _pending.begin()->first;
+    _pending.erase(_pending.begin());
+    _incompleteCount.fetch_add(1, std::memory_order_relaxed);
+  }
+
+  /********************************************************************************************************************/
+
+} // namespace ChimeraTK
@@ -0,0 +1,198 @@
+// SPDX-FileCopyrightText: Deutsches Elektronen-Synchrotron DESY, MSK, ChimeraTK Project <chimeratk-support@desy.de>
+// SPDX-License-Identifier: LGPL-3.0-or-later
+
+#include "DoocsBackendLatencyTracing.h"
+
+#include <ChimeraTK/Exception.h>
+
+#include <algorithm>
+#include <fstream>
+
+namespace ChimeraTK {
+
+  /********************************************************************************************************************/
+
+  namespace {
+
+    int64_t toMicroseconds(std::chrono::steady_clock::duration d) {
+      return std::chrono::duration_cast<std::chrono::microseconds>(d).count();
+    }
+
+    LatencyPercentiles computePercentiles(std::vector<int64_t> samples) {
+      LatencyPercentiles result;
+      if(samples.empty()) return result;
+      std::sort(samples.begin(), samples.end());
+      auto at = [&](double fraction) { return samples[size_t(fraction * double(samples.size() - 1))]; };
+      result.p50 = at(0.50);
+      result.p90 = at(0.90);
+      result.p99 = at(0.99);
+      result.max = samples.back();
+      return result;
+    }
+
+    /// Escape string for use in JSON
+    std::string escape(const std::string& s) {
+      std::string result;
+      for(char c : s) {
+        if(c == '"' || c == '\\') result += '\\';
+        result += c;
+      }
+      return result;
+    }
+
+  } // namespace
+
+  /********************************************************************************************************************/
+
+  LatencyTracer::Channel::Channel(LatencyTracer& tracer, uint32_t id, std::string path)
+  : _tracer(tracer), _id(id), _path(std::move(path)) {}
+
+  /********************************************************************************************************************/
+
+  void LatencyTracer::Channel::record(
+      const NotificationTrace& trace, std::chrono::steady_clock::time_point readReturned) {
+    if(!trace.isValid()) return;
+
+    auto callbackToEnqueue = toMicroseconds(trace.enqueued - trace.callback);
+    auto enqueueToRead = toMicroseconds(readReturned - trace.enqueued);
+    auto serverToCallback = trace.serverTimeUs != 0 ? trace.callbackTimeUs - trace.serverTimeUs : 0;
+
+    {
+      std::lock_guard<std::mutex> lk(_mx);
+      if(_count < samplesPerChannel) {
+        _serverToCallback.push_back(serverToCallback);
+        _callbackToEnqueue.push_back(callbackToEnqueue);
+        _enqueueToRead.push_back(enqueueToRead);
+        _total.push_back(serverToCallback + callbackToEnqueue + enqueueToRead);
+      }
+      else {
+        auto i = _count % samplesPerChannel;
+        _serverToCallback[i] = serverToCallback;
+        _callbackToEnqueue[i] = callbackToEnqueue;
+        _enqueueToRead[i] = enqueueToRead;
+        _total[i] = serverToCallback + callbackToEnqueue + enqueueToRead;
+      }
+      ++_count;
+    }
+
+    auto enqueuedTimeUs = trace.callbackTimeUs + callbackToEnqueue;
+    _tracer.addEvent({_id, trace.serverTimeUs, trace.callbackTimeUs, enqueuedTimeUs, enqueuedTimeUs + enqueueToRead});
+  }
+
+  /********************************************************************************************************************/
+
+  LatencyReport LatencyTracer::Channel::getReport() const {
+    std::lock_guard<std::mutex> lk(_mx);
+    LatencyReport report;
+    report.path = _path;
+    report.count = _total.size();
+    report.serverToCallback = computePercentiles(_serverToCallback);
+    report.callbackToEnqueue = computePercentiles(_callbackToEnqueue);
+    report.enqueueToRead = computePercentiles(_enqueueToRead);
+    report.total = computePercentiles(_total);
+    return report;
+  }
+
+  /********************************************************************************************************************/
+
+  void LatencyTracer::enable(size_t maxEvents) {
+    std::lock_guard<std::mutex> lk(_mx);
+    _maxEvents = maxEvents;
+    _enabled = true;
+  }
+
+  /********************************************************************************************************************/
+
+  std::shared_ptr<LatencyTracer::Channel> LatencyTracer::createChannel(const std::string& path) {
+    if(!isEnabled()) return nullptr;
+    std::lock_guard<std::mutex> lk(_mx);
+    auto channel = std::make_shared<Channel>(*this, uint32_t(_channelNames.size()), path);
+    _channelNames.push_back(path);
+    _channels.push_back(channel);
+    return channel;
+  }
+
+  /********************************************************************************************************************/
+
+  std::vector<LatencyReport> LatencyTracer::getReports() const {
+    std::vector<std::shared_ptr<Channel>> channels;
+    {
+      std::lock_guard<std::mutex> lk(_mx);
+      for(const auto& weak : _channels) {
+        auto channel = weak.lock();
+        if(channel) channels.push_back(channel);
+      }
+    }
+    std::vector<LatencyReport> reports;
+    reports.reserve(channels.size());
+    for(const auto& channel : channels) {
+      reports.push_back(channel->getReport());
+    }
+    return reports;
+  }
+
+  /********************************************************************************************************************/
+
+  void LatencyTracer::addEvent(const Event& event) {
+    std::lock_guard<std::mutex> lk(_mx);
+    if(_maxEvents == 0) return;
+    if(_events.size() >= _maxEvents) _events.pop_front();
+    _events.push_back(event);
+  }
+
+  /********************************************************************************************************************/
+
+  void LatencyTracer::writeChromeTrace(std::ostream& os) const {
+    std::lock_guard<std::mutex> lk(_mx);
+
+    os << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+    bool first = true;
+    auto writeEvent = [&](uint32_t tid, const char* name, int64_t begin, int64_t end) {
+      if(end < begin) return; // e.g. server clock ahead of ours
+      if(!first) os << ",";
+      first = false;
+      os << "\n{\"name\":\"" << name << "\",\"cat\":\"doocs\",\"ph\":\"X\",\"pid\":1,\"tid\":" << tid
+         << ",\"ts\":" << begin << ",\"dur\":" << (end - begin) << "}";
+    };
+
+    // name the tracks after the accessors
+    for(size_t i = 0; i < _channelNames.size(); ++i) {
+      if(!first) os << ",";
+      first = false;
+      os << "\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << i << ",\"args\":{\"name\":\""
+         << escape(_channelNames[i]) << "\"}}";
+    }
+
+    for(const auto& e : _events) {
+      if(e.serverTimeUs != 0) writeEvent(e.channel, "server to callback", e.serverTimeUs, e.callbackTimeUs);
+      writeEvent(e.channel, "callback to enqueue", e.callbackTimeUs, e.enqueuedTimeUs);
+      writeEvent(e.channel, "enqueue to read", e.enqueuedTimeUs, e.readTimeUs);
+    }
+    os << "\n]}\n";
+  }
+
+  /********************************************************************************************************************/
+
+  void LatencyTracer::writeChromeTrace(const std::string& fileName) const {
+    std::ofstream f(fileName);
+    if(!f) {
+      throw ChimeraTK::runtime_error("Cannot open trace file '" + fileName + "' for writing.");
+    }
+    writeChromeTrace(f);
+  }
+
+  /********************************************************************************************************************/
+
+  NotificationTrace LatencyTracer::begin(int64_t serverSec, int64_t serverUsec) {
+    NotificationTrace trace;
+    trace.callback = std::chrono::steady_clock::now();
+    trace.callbackTimeUs =
+        std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::system_clock::now().time_since_epoch())
+            .count();
+    trace.serverTimeUs = serverSec * 1000000 + serverUsec;
+    return trace;
+  }
+
+  /********************************************************************************************************************/
+
+} // namespace ChimeraTK
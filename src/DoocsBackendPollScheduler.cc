@@ -0,0 +1,287 @@
+// SPDX-FileCopyrightText: Deutsches Elektronen-Synchrotron DESY, MSK, ChimeraTK Project <chimeratk-support@desy.de>
+// SPDX-License-Identifier: LGPL-3.0-or-later
+
+#include "DoocsBackendPollScheduler.h"
+
+#include "DoocsBackendRegisterAccessor.h"
+
+#include <eq_errors.h>
+
+#include <algorithm>
+
+namespace ChimeraTK {
+
+  /********************************************************************************************************************/
+
+  DoocsBackendPollScheduler::DoocsBackendPollScheduler(
+      DoocsBackend& backend, std::chrono::milliseconds period, size_t maxThreads)
+  : _backend(backend), _period(period), _maxThreads(std::max<size_t>(maxThreads, 1)) {}
+
+  /********************************************************************************************************************/
+
+  DoocsBackendPollScheduler::~DoocsBackendPollScheduler() {
+    {
+      std::lock_guard<std::mutex> lk(_mx);
+      _stop = true;
+    }
+    _cv.notify_all();
+    if(_thread.joinable()) _thread.join();
+
+    // the pollers are stopped last, since run() might wait for them
+    {
+      std::lock_guard<std::mutex> lk(_mxWork);
+      _stopPollers = true;
+    }
+    _cvWork.notify_all();
+    for(auto& poller : _pollers) poller.join();
+  }
+
+  /********************************************************************************************************************/
+
+  void DoocsBackendPollScheduler::add(DoocsBackendRegisterAccessorBase* accessor) {
+    {
+      std::lock_guard<std::mutex> lk(_mx);
+      auto& property = _properties[accessor->_path];
+      if(!property) {
+        property = std::make_shared<Property>(accessor->_path);
+        property->ea = _backend._addressCache.get(accessor->_path);
+        ++_locations[getLocation(accessor->_path)];
+      }
+      property->listeners.push_back(accessor);
+      startThreads();
+      if(!_active) return;
+      // provide the initial value without waiting for the next period
+      _pollNow = true;
+    }
+    _cv.notify_all();
+  }
+
+  /********************************************************************************************************************/
+
+  void DoocsBackendPollScheduler::remove(DoocsBackendRegisterAccessorBase* accessor) {
+    std::lock_guard<std::mutex> lk(_mx);
+    auto it = _properties.find(accessor->_path);
+    if(it == _properties.end()) return;
+    auto& listeners = it->second->listeners;
+    listeners.erase(std::remove(listeners.begin(), listeners.end(), accessor), listeners.end());
+    if(listeners.empty()) {
+      auto location = _locations.find(getLocation(it->first));
+      if(--location->second == 0) _locations.erase(location);
+      _properties.erase(it);
+    }
+  }
+
+  /********************************************************************************************************************/
+
+  std::string DoocsBackendPollScheduler::getLocation(const std::string& path) {
+    return path.substr(0, path.find_last_of('/'));
+  }
+
+  /********************************************************************************************************************/
+
+  void DoocsBackendPollScheduler::startThreads() {
+    if(!_thread.joinable()) {
+      _thread = std::thread([this] { run(); });
+    }
+    // the scheduler thread reads as well, hence one poller less than locations
+    auto nPollers = std::min(_locations.size(), _maxThreads) - 1;
+    while(_pollers.size() < nPollers) {
+      _pollers.emplace_back([this] { runPoller(); });
+    }
+  }
+
+  /********************************************************************************************************************/
+
+  void DoocsBackendPollScheduler::activate() {
+    {
+      std::lock_guard<std::mutex> lk(_mx);
+      _active = true;
+      _pollNow = true;
+      for(auto& [path, property] : _properties) {
+        property->hasException = false;
+        for(auto* listener : property->listeners) listener->resetChangeFilter();
+      }
+    }
+    _cv.notify_all();
+  }
+
+  /********************************************************************************************************************/
+
+  void DoocsBackendPollScheduler::deactivate() {
+    {
+      std::lock_guard<std::mutex> lk(_mx);
+      _active = false;
+      ++_generation;
+    }
+    _cv.notify_all();
+  }
+
+  /********************************************************************************************************************/
+
+  void DoocsBackendPollScheduler::deactivateAndPushException(const std::string& message) {
+    std::lock_guard<std::mutex> lk(_mx);
+    _active = false;
+    ++_generation;
+    for(auto& [path, property] : _properties) {
+      pushException(*property, message);
+    }
+  }
+
+  /********************************************************************************************************************/
+
+  void DoocsBackendPollScheduler::pushException(Property& property, const std::string& message) {
+    // Nothing must be pushed after the exception until the next activate(). (see. Spec B.9.3.1 and B.9.3.2)
+    if(property.hasException) return;
+    property.hasException = true;
+    try {
+      throw ChimeraTK::runtime_error(message);
+    }
+    catch(...) {
+      for(auto* listener : property.listeners) {
+        listener->notifications.push_overwrite_exception(std::current_exception());
+      }
+    }
+  }
+
+  /********************************************************************************************************************/
+
+  void DoocsBackendPollScheduler::run() {
+    std::unique_lock<std::mutex> lk(_mx);
+    auto next = std::chrono::steady_clock::now();
+    while(true) {
+      auto isDue = [&] {
+        return _stop || (_active && (_pollNow || std::chrono::steady_clock::now() >= next));
+      };
+      while(!isDue()) {
+        if(_active) {
+          _cv.wait_until(lk, next);
+        }
+        else {
+          _cv.wait(lk);
+        }
+      }
+      if(_stop) return;
+
+      // Schedule with a fixed rate. If the period has been exceeded, continue with a full period from now on instead
+      // of polling repeatedly to catch up.
+      _pollNow = false;
+      auto now = std::chrono::steady_clock::now();
+      next += _period;
+      if(next < now) next = now + _period;
+
+      auto generation = _generation;
+      std::vector<Result> results;
+      results.reserve(_properties.size());
+      for(auto& [path, property] : _properties) {
+        if(property->hasException) continue;
+        auto& result = results.emplace_back();
+        result.path = path;
+        result.property = property;
+      }
+      lk.unlock();
+
+      // read all properties, together with the pollers if there is more than one
+      if(results.size() > 1) {
+        {
+          std::lock_guard<std::mutex> lkWork(_mxWork);
+          _work = &results;
+          _nextWork = 0;
+          ++_round;
+        }
+        _cvWork.notify_all();
+        pollAll(results);
+        // wait until the pollers are done with the results, pollers waking up later find no work
+        std::unique_lock<std::mutex> lkWork(_mxWork);
+        _work = nullptr;
+        _cvWorkDone.wait(lkWork, [&] { return _nBusy == 0; });
+      }
+      else if(!results.empty()) {
+        poll(results.front());
+      }
+
+      distribute(results, generation);
+      lk.lock();
+    }
+  }
+
+  /********************************************************************************************************************/
+
+  void DoocsBackendPollScheduler::runPoller() {
+    std::unique_lock<std::mutex> lk(_mxWork);
+    size_t round = 0;
+    while(true) {
+      _cvWork.wait(lk, [&] { return _stopPollers || (_work && _round != round); });
+      if(_stopPollers) return;
+      round = _round;
+      auto& results = *_work;
+      ++_nBusy;
+      lk.unlock();
+      pollAll(results);
+      lk.lock();
+      if(--_nBusy == 0) _cvWorkDone.notify_all();
+    }
+  }
+
+  /********************************************************************************************************************/
+
+  void DoocsBackendPollScheduler::pollAll(std::vector<Result>& results) {
+    for(size_t i = _nextWork++; i < results.size(); i = _nextWork++) {
+      poll(results[i]);
+    }
+  }
+
+  /********************************************************************************************************************/
+
+  void DoocsBackendPollScheduler::poll(Result& result) {
+    auto& property = *result.property;
+    doocs::EqData src;
+    auto start = std::chrono::steady_clock::now();
+    result.rc = property.eq.get(&property.ea, &src, &result.dst, _backend._rpcTimeout);
+    result.failed = result.rc == doocs::TransactionResult::transaction_error ||
+        result.rc == doocs::TransactionResult::transport_error;
+    _backend._statistics.recordRead(std::chrono::steady_clock::now() - start, !result.failed);
+    if(property.eq.hasTimedOut()) _backend._statistics.recordTimeout();
+    if(result.failed) {
+      result.errorMessage =
+          "Cannot read from DOOCS property '" + result.path + "': " + property.eq.getErrorMessage(result.dst);
+    }
+  }
+
+  /********************************************************************************************************************/
+
+  void DoocsBackendPollScheduler::distribute(std::vector<Result>& results, size_t generation) {
+    std::vector<std::string> failedPaths;
+    {
+      std::lock_guard<std::mutex> lk(_mx);
+      // discard values read before a deactivation
+      if(!_active || generation != _generation) return;
+
+      for(auto& result : results) {
+        auto& property = *result.property;
+        if(result.failed) {
+          pushException(property, result.errorMessage);
+          failedPaths.push_back(result.path);
+          continue;
+        }
+        if(result.dst.error() == 0) {
+          _backend._snapshotCache.update(result.path, result.dst, DoocsBackendSnapshotCache::Source::subscription);
+        }
+        // the property might have been removed meanwhile, then the listeners are empty
+        for(auto* listener : property.listeners) {
+          if(!listener->passesChangeFilter(result.dst)) continue;
+          auto buffer = listener->_eqDataPool->acquire();
+          *buffer = result.dst;
+          listener->notifications.push_overwrite(DoocsBackendNotification{std::move(buffer), {}});
+        }
+      }
+    }
+
+    // report the errors to the backend, so open() checks the failed property for recovery
+    for(auto& path : failedPaths) {
+      _backend.informRuntimeError(path);
+    }
+  }
+
+  /********************************************************************************************************************/
+
+} // namespace ChimeraTK
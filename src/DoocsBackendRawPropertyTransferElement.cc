@@ -0,0 +1,180 @@
+// SPDX-FileCopyrightText: Deutsches Elektronen-Synchrotron DESY, MSK, ChimeraTK Project <chimeratk-support@desy.de>
+// SPDX-License-Identifier: LGPL-3.0-or-later
+
+#include "DoocsBackendRawPropertyTransferElement.h"
+
+#include "DoocsBackend.h"
+
+#include <eq_errors.h>
+
+#include <algorithm>
+#include <cassert>
+#include <chrono>
+#include <iterator>
+
+namespace ChimeraTK {
+
+  /********************************************************************************************************************/
+
+  DoocsBackendRawPropertyTransferElement::DoocsBackendRawPropertyTransferElement(
+      boost::shared_ptr<DoocsBackend> backend, const std::string& path, int doocsTypeId, size_t length, size_t nUnits)
+  : TransferElement(path, {}), _backend(std::move(backend)), _path(path), _doocsTypeId(doocsTypeId), _length(length),
+    _eq(path), _nUnits(nUnits) {
+    _ea = _backend->_addressCache.get(_path);
+    resetWriteBuffer();
+  }
+
+  /********************************************************************************************************************/
+
+  void DoocsBackendRawPropertyTransferElement::resetWriteBuffer() {
+    // prepare the write buffer with the right type. The array is allocated on the first write (see doPreWrite()).
+    src = doocs::EqData();
+    if(_doocsTypeId == DATA_IFFF) {
+      IFFF init{};
+      src.set(&init);
+    }
+    else if(_doocsTypeId == DATA_USTR) {
+      src.set(0, 0.f, 0.f, time_t(0), "");
+    }
+    else {
+      src.set_type(_doocsTypeId);
+    }
+  }
+
+  /********************************************************************************************************************/
+
+  std::chrono::milliseconds DoocsBackendRawPropertyTransferElement::getRpcTimeout() const {
+    return _rpcTimeout.value_or(_backend->_rpcTimeout);
+  }
+
+  /********************************************************************************************************************/
+
+  void DoocsBackendRawPropertyTransferElement::addCoverage(size_t begin, size_t end) {
+    assert(end <= _nUnits);
+    if(begin >= end) return;
+    // merge with an overlapping or adjacent range starting before
+    auto it = _covered.upper_bound(begin);
+    if(it != _covered.begin() && std::prev(it)->second >= begin) {
+      --it;
+      begin = it->first;
+      end = std::max(end, it->second);
+      it = _covered.erase(it);
+    }
+    // merge with all overlapping or adjacent ranges starting after
+    while(it != _covered.end() && it->first <= end) {
+      end = std::max(end, it->second);
+      it = _covered.erase(it);
+    }
+    _covered.emplace(begin, end);
+  }
+
+  /********************************************************************************************************************/
+
+  bool DoocsBackendRawPropertyTransferElement::mayReplaceOther(
+      const boost::shared_ptr<TransferElement const>& other) const {
+    auto rhsCasted = boost::dynamic_pointer_cast<const DoocsBackendRawPropertyTransferElement>(other);
+    if(!rhsCasted) return false;
+    if(rhsCasted.get() == this) return false;
+    if(_backend != rhsCasted->_backend) return false;
+    if(_path != rhsCasted->_path) return false;
+    if(_doocsTypeId != rhsCasted->_doocsTypeId) return false;
+    if(_length != rhsCasted->_length) return false;
+    if(_nUnits != rhsCasted->_nUnits) return false;
+    return true;
+  }
+
+  /********************************************************************************************************************/
+
+  void DoocsBackendRawPropertyTransferElement::doReadTransferSynchronously() {
+    _backend->checkActiveException();
+
+    boost::this_thread::interruption_point();
+
+    // make sure we read back values written asynchronously before
+    if(_backend->_asyncWriter) {
+      _backend->_asyncWriter->flush(_path);
+    }
+
+    doocs::EqData tmp;
+    auto start = std::chrono::steady_clock::now();
+    int rc = _eq.get(&_ea, &tmp, &dst, getRpcTimeout());
+    bool failed = rc == doocs::TransactionResult::transaction_error || rc == doocs::TransactionResult::transport_error;
+    _backend->_statistics.recordRead(std::chrono::steady_clock::now() - start, !failed);
+    if(_eq.hasTimedOut()) _backend->_statistics.recordTimeout();
+
+    if(failed) {
+      _backend->informRuntimeError(_path);
+      throw ChimeraTK::runtime_error(std::string("Cannot read from DOOCS property: ") + _eq.getErrorMessage(dst));
+    }
+    if(dst.error() == 0) {
+      _backend->_snapshotCache.update(_path, dst, DoocsBackendSnapshotCache::Source::read);
+    }
+  }
+
+  /********************************************************************************************************************/
+
+  void DoocsBackendRawPropertyTransferElement::readForModify() {
+    if(_backend->_snapshotCache.get(_path, dst)) {
+      return;
+    }
+    doReadTransferSynchronously();
+  }
+
+  /********************************************************************************************************************/
+
+  void DoocsBackendRawPropertyTransferElement::doPreWrite(TransferType, VersionNumber) {
+    if(!hasStructType() && size_t(src.length()) < _length) {
+      src.length(int(_length));
+    }
+
+    if(isFullyCovered()) {
+      // the accessors will overwrite everything
+      return;
+    }
+
+    // read-modify-write: start from the current value
+    readForModify();
+    src = dst;
+    // make sure the array is long enough, as the remote server might have changed the length on its side
+    if(!hasStructType() && size_t(src.length()) < _length) {
+      src.length(_length);
+    }
+  }
+
+  /********************************************************************************************************************/
+
+  bool DoocsBackendRawPropertyTransferElement::doWriteTransfer(VersionNumber) {
+    _backend->checkActiveException();
+
+    if(_backend->_asyncWriter) {
+      _backend->_snapshotCache.update(_path, src, DoocsBackendSnapshotCache::Source::write);
+      return _backend->_asyncWriter->enqueue(_path, src);
+    }
+
+    doocs::EqData reply;
+    _backend->_snapshotCache.beginWrite(_path);
+    auto start = std::chrono::steady_clock::now();
+    int rc = _eq.set(&_ea, &src, &reply, getRpcTimeout());
+    bool readOnly = !_eq.hasTimedOut() && reply.error() == eq_errors::read_only;
+    bool failed =
+        rc == doocs::TransactionResult::transaction_error || rc == doocs::TransactionResult::transport_error || readOnly;
+    _backend->_statistics.recordWrite(std::chrono::steady_clock::now() - start, !failed);
+    if(_eq.hasTimedOut()) _backend->_statistics.recordTimeout();
+    if(failed) {
+      _backend->_snapshotCache.endWrite(_path, false);
+      _backend->informRuntimeError(_path);
+      // the content of src is still in use by the abandoned call
+      if(_eq.hasTimedOut()) resetWriteBuffer();
+      if(readOnly) {
+        _isWriteable = false;
+      }
+      throw ChimeraTK::runtime_error(std::string("Cannot write to DOOCS property: ") + _eq.getErrorMessage(reply));
+    }
+    _backend->_snapshotCache.update(_path, src, DoocsBackendSnapshotCache::Source::write);
+    _backend->_snapshotCache.endWrite(_path, true);
+    return false;
+  }
+
+  /********************************************************************************************************************/
+
+} // namespace ChimeraTK
@@ -0,0 +1,103 @@
+// SPDX-FileCopyrightText: Deutsches Elektronen-Synchrotron DESY, MSK, ChimeraTK Project <chimeratk-support@desy.de>
+// SPDX-License-Identifier: LGPL-3.0-or-later
+
+#include "DoocsBackendThreadSettings.h"
+
+#include <ChimeraTK/Exception.h>
+
+#include <pthread.h>
+#include <sched.h>
+
+#include <cstring>
+#include <map>
+#include <sstream>
+
+namespace ChimeraTK {
+
+  /********************************************************************************************************************/
+
+  DoocsBackendThreadSettings DoocsBackendThreadSettings::parse(
+      const std::string& cpus, const std::string& policy, const std::string& priority) {
+    DoocsBackendThreadSettings settings;
+
+    auto toInt = [](const std::string& value, const std::string& name) {
+      try {
+        size_t pos;
+        int result = std::stoi(value, &pos);
+        if(pos != value.size() || result < 0) throw std::invalid_argument(value);
+        return result;
+      }
+      catch(std::exception&) {
+        throw ChimeraTK::logic_error("DoocsBackend: invalid value for parameter " + name + ": " + value);
+      }
+    };
+
+    std::stringstream list(cpus);
+    std::string item;
+    while(std::getline(list, item, ',')) {
+      if(item.empty()) continue;
+      auto dash = item.find('-');
+      if(dash == std::string::npos) {
+        settings.cpus.push_back(toInt(item, "zmqCpus"));
+        continue;
+      }
+      auto first = toInt(item.substr(0, dash), "zmqCpus");
+      auto last = toInt(item.substr(dash + 1), "zmqCpus");
+      if(last < first || last >= CPU_SETSIZE) {
+        throw ChimeraTK::logic_error("DoocsBackend: invalid value for parameter zmqCpus: " + cpus);
+      }
+      for(int cpu = first; cpu <= last; ++cpu) settings.cpus.push_back(cpu);
+    }
+    for(auto cpu : settings.cpus) {
+      if(cpu >= CPU_SETSIZE) {
+        throw ChimeraTK::logic_error("DoocsBackend: invalid value for parameter zmqCpus: " + cpus);
+      }
+    }
+
+    static const std::map<std::string, int> policies{{"other", SCHED_OTHER}, {"batch", SCHED_BATCH},
+        {"idle", SCHED_IDLE}, {"fifo", SCHED_FIFO}, {"rr", SCHED_RR}};
+    if(!policy.empty()) {
+      auto it = policies.find(policy);
+      if(it == policies.end()) {
+        throw ChimeraTK::logic_error("DoocsBackend: invalid value for parameter zmqSchedPolicy: " + policy);
+      }
+      settings.policy = it->second;
+    }
+    if(!priority.empty()) {
+      settings.priority = toInt(priority, "zmqPriority");
+      if(!settings.policy) settings.policy = SCHED_FIFO;
+    }
+    if(settings.policy) {
+      if(settings.priority < sched_get_priority_min(*settings.policy) ||
+          settings.priority > sched_get_priority_max(*settings.policy)) {
+        throw ChimeraTK::logic_error("DoocsBackend: parameter zmqPriority out of range for the scheduling policy: " +
+            std::to_string(settings.priority));
+      }
+    }
+
+    return settings;
+  }
+
+  /********************************************************************************************************************/
+
+  std::string DoocsBackendThreadSettings::applyToCurrentThread() const {
+    std::string errors;
+    if(!cpus.empty()) {
+      cpu_set_t set;
+      CPU_ZERO(&set);
+      for(auto cpu : cpus) CPU_SET(cpu, &set);
+      int rc = pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+      if(rc != 0) errors += std::string("cannot set CPU affinity: ") + std::strerror(rc) + ". ";
+    }
+    if(policy) {
+      sched_param param{};
+      param.sched_priority = priority;
+      int rc = pthread_setschedparam(pthread_self(), *policy, &param);
+      if(rc != 0) errors += std::string("cannot set scheduling policy: ") + std::strerror(rc) + ". ";
+    }
+    return errors;
+  }
+
+  /********************************************************************************************************************/
+
+} // namespace ChimeraTK
@@ -0,0 +1,271 @@
+// SPDX-FileCopyrightText: Deutsches Elektronen-Synchrotron DESY, MSK, ChimeraTK Project <chimeratk-support@desy.de>
+// SPDX-License-Identifier: LGPL-3.0-or-later
+
+#include "DoocsBackendTimedRpc.h"
+
+#include <algorithm>
+#include <condition_variable>
+#include <deque>
+#include <map>
+#include <mutex>
+#include <thread>
+
+namespace ChimeraTK {
+
+  /********************************************************************************************************************/
+
+  namespace {
+    thread_local std::optional<std::chrono::steady_clock::time_point> currentDeadline;
+  } // namespace
+
+  /********************************************************************************************************************/
+
+  DoocsBackendRpcDeadline::DoocsBackendRpcDeadline(std::chrono::steady_clock::time_point deadline)
+  : _previous(currentDeadline) {
+    currentDeadline = deadline;
+  }
+
+  /********************************************************************************************************************/
+
+  DoocsBackendRpcDeadline::~DoocsBackendRpcDeadline() {
+    currentDeadline = _previous;
+  }
+
+  /********************************************************************************************************************/
+
+  std::optional<std::chrono::steady_clock::time_point> DoocsBackendRpcDeadline::current() {
+    return currentDeadline;
+  }
+
+  /********************************************************************************************************************/
+  /********************************************************************************************************************/
+
+  struct DoocsBackendTimedRpc::Job {
+    enum class State { queued, running, done };
+
+    bool isSet{false};
+    doocs::EqAdr ea;
+    doocs::EqData src, dst;
+    int rc{0};
+    State state{State::done};
+
+    /// whether the caller has stopped waiting for the result
+    bool abandoned{false};
+
+    /// receives the result of calls started with getAsync(), which have no waiting caller
+    std::optional<std::promise<AsyncResult>> promise;
+  };
+
+  /********************************************************************************************************************/
+
+  struct DoocsBackendTimedRpc::Location {
+    /// mutex protecting all members below and the state of the jobs
+    std::mutex mx;
+    std::condition_variable cvWork;
+    std::condition_variable cvDone;
+
+    std::deque<std::shared_ptr<Job>> queue;
+    size_t nWorkers{0};
+    size_t nIdle{0};
+
+    /// number of abandoned jobs which are still running
+    size_t nAbandoned{0};
+
+    /// number of jobs started with getAsync() which have not yet returned
+    size_t nBackground{0};
+
+    /// Queue the job and start a worker if none is idle (mx must be locked)
+    static void push(const std::shared_ptr<Location>& self, std::shared_ptr<Job> job);
+
+    /// Worker thread function. The thread keeps the location alive, so it may outlive all call objects.
+    static void run(std::shared_ptr<Location> self);
+  };
+
+  /********************************************************************************************************************/
+
+  void DoocsBackendTimedRpc::Location::push(const std::shared_ptr<Location>& self, std::shared_ptr<Job> job) {
+    job->state = Job::State::queued;
+    self->queue.push_back(std::move(job));
+    if(self->nIdle == 0 && self->nWorkers < maxWorkersPerLocation) {
+      ++self->nWorkers;
+      ++self->nIdle;
+      std::thread(run, self).detach();
+    }
+    self->cvWork.notify_one();
+  }
+
+  /********************************************************************************************************************/
+
+  void DoocsBackendTimedRpc::Location::run(std::shared_ptr<Location> self) {
+    doocs::EqCall eq;
+    std::unique_lock<std::mutex> lk(self->mx);
+    while(true) {
+      if(!self->cvWork.wait_for(lk, workerIdleTime, [&] { return !self->queue.empty(); })) {
+        // idle for too long: end the thread, a new one is started on demand
+        --self->nIdle;
+        --self->nWorkers;
+        return;
+      }
+      auto job = std::move(self->queue.front());
+      self->queue.pop_front();
+      --self->nIdle;
+      job->state = Job::State::running;
+      lk.unlock();
+
+      auto start = std::chrono::steady_clock::now();
+      int rc = job->isSet ? eq.set(&job->ea, &job->src, &job->dst) : eq.get(&job->ea, &job->src, &job->dst);
+      auto latency = std::chrono::steady_clock::now() - start;
+
+      lk.lock();
+      job->rc = rc;
+      job->state = Job::State::done;
+      if(job->abandoned) {
+        --self->nAbandoned;
+      }
+      if(job->promise) {
+        --self->nBackground;
+        job->promise->set_value({rc, job->ea, job->dst.get_string(), latency});
+      }
+      ++self->nIdle;
+      self->cvDone.notify_all();
+    }
+  }
+
+  /********************************************************************************************************************/
+
+  std::shared_ptr<DoocsBackendTimedRpc::Location> DoocsBackendTimedRpc::getLocation(const std::string& address) {
+    // Deliberately leaked: the map is never destroyed, so calls made during the static destruction at exit and the
+    // detached workers (which may still hang in a call) never see a destroyed map or mutex.
+    struct Registry {
+      std::mutex mx;
+      std::map<std::string, std::shared_ptr<Location>> locations;
+    };
+    static auto* registry = new Registry;
+
+    std::lock_guard<std::mutex> lk(registry->mx);
+    auto& location = registry->locations[address.substr(0, address.find_last_of('/'))];
+    if(!location) {
+      location = std::make_shared<Location>();
+    }
+    return location;
+  }
+
+  /********************************************************************************************************************/
+
+  int DoocsBackendTimedRpc::get(
+      doocs::EqAdr* ea, doocs::EqData* src, doocs::EqData* dst, std::chrono::milliseconds timeout) {
+    return call(false, ea, src, dst, timeout);
+  }
+
+  /********************************************************************************************************************/
+
+  int DoocsBackendTimedRpc::set(
+      doocs::EqAdr* ea, doocs::EqData* src, doocs::EqData* dst, std::chrono::milliseconds timeout) {
+    return call(true, ea, src, dst, timeout);
+  }
+
+  /********************************************************************************************************************/
+
+  std::string DoocsBackendTimedRpc::getErrorMessage(const doocs::EqData& dst) const {
+    if(_timedOut) return _timeoutReason;
+    return dst.get_string();
+  }
+
+  /********************************************************************************************************************/
+
+  std::future<DoocsBackendTimedRpc::AsyncResult> DoocsBackendTimedRpc::getAsync(
+      const std::string& address, const doocs::EqAdr& ea) {
+    auto location = getLocation(address);
+    auto job = std::make_shared<Job>();
+    job->ea = ea;
+    job->promise.emplace();
+    auto future = job->promise->get_future();
+
+    std::lock_guard<std::mutex> lk(location->mx);
+    if(location->nAbandoned > 0 || location->nBackground >= maxWorkersPerLocation) {
+      std::string message = location->nAbandoned > 0 ?
+          "previous call to the location has not yet returned after timeout" :
+          "too many pending calls to the location";
+      job->promise->set_value({int(doocs::TransactionResult::transport_error), ea, message, {}});
+      return future;
+    }
+    ++location->nBackground;
+    Location::push(location, std::move(job));
+    return future;
+  }
+
+  /********************************************************************************************************************/
+
+  int DoocsBackendTimedRpc::call(
+      bool isSet, doocs::EqAdr* ea, doocs::EqData* src, doocs::EqData* dst, std::chrono::milliseconds timeout) {
+    _timedOut = false;
+
+    auto deadline = DoocsBackendRpcDeadline::current();
+    if(timeout.count() <= 0 && !deadline) {
+      // fast path: no timeout requested
+      return isSet ? _eq.set(ea, src, dst) : _eq.get(ea, src, dst);
+    }
+
+    auto now = std::chrono::steady_clock::now();
+    auto until = std::chrono::steady_clock::time_point::max();
+    if(timeout.count() > 0) until = now + timeout;
+    if(deadline && *deadline < until) until = *deadline;
+
+    auto fail = [&](const std::string& reason) {
+      _timedOut = true;
+      _timeoutReason = reason;
+      return int(doocs::TransactionResult::transport_error);
+    };
+
+    if(now >= until) {
+      return fail("deadline exceeded before the call was started");
+    }
+
+    if(!_location) _location = getLocation(_address);
+    auto& location = *_location;
+    if(!_job) _job = std::make_shared<Job>();
+    auto& job = *_job;
+
+    std::unique_lock<std::mutex> lk(location.mx);
+    if(location.nAbandoned > 0) {
+      return fail("previous call to the location has not yet returned after timeout");
+    }
+
+    // hand the buffers over to the worker
+    int srcType = src->type();
+    job.isSet = isSet;
+    job.ea = *ea;
+    std::swap(job.src, *src);
+    std::swap(job.dst, *dst);
+    Location::push(_location, _job);
+
+    if(!location.cvDone.wait_until(lk, until, [&] { return job.state == Job::State::done; })) {
+      auto reason = "no reply within " +
+          std::to_string(std::chrono::duration_cast<std::chrono::milliseconds>(until - now).count()) + " ms";
+      if(job.state == Job::State::queued) {
+        // not yet started (all workers busy): take the buffers back
+        location.queue.erase(std::find(location.queue.begin(), location.queue.end(), _job));
+        std::swap(job.src, *src);
+        std::swap(job.dst, *dst);
+        job.state = Job::State::done;
+        return fail(reason);
+      }
+      // the worker keeps the job with the buffers until the call returns
+      job.abandoned = true;
+      ++location.nAbandoned;
+      _job.reset();
+      *src = doocs::EqData();
+      src->set_type(srcType);
+      *dst = doocs::EqData();
+      return fail(reason);
+    }
+
+    std::swap(job.src, *src);
+    std::swap(job.dst, *dst);
+    *ea = job.ea;
+    return job.rc;
+  }
+
+  /********************************************************************************************************************/
+
+} // namespace ChimeraTK
@@ -8,97 +8,217 @@
 
 void DoocsBackendRegisterCatalogue::addProperty(
     const std::string& name, unsigned int length, int doocsType, ChimeraTK::AccessModeFlags flags) {
+  using Field = DoocsBackendRegisterInfo::Field;
   DoocsBackendRegisterInfo info;
-
-  info._name = name;
+  setName(info, name);
   info._length = length;
   info.doocsTypeId = doocsType;
-  info.accessModeFlags = flags;
+  info._zmqAvailable = flags.has(ChimeraTK::AccessMode::wait_for_new_data);
+  info._dataDescriptor = &DoocsBackendRegisterInfo::getSharedDataDescriptor(doocsType);
+
+  auto addIfNotExisting = [&](const DoocsBackendRegisterInfo& i) {
+    if(!hasRegister(i.getRegisterName())) addRegister(i);
+  };
 
   if(info._length == 0) {
     // DOOCS reports 0 if not an array
     info._length = 1;
   }
-  if(doocsType == DATA_TEXT || doocsType == DATA_STRING || doocsType == DATA_USTR) {
+  if(doocsType == DATA_TEXT || doocsType == DATA_STRING) {
     // in case of strings, DOOCS reports the length of the string
     info._length = 1;
-    info.dataDescriptor = ChimeraTK::DataDescriptor(ChimeraTK::DataDescriptor::FundamentalType::string);
-    if(!hasRegister(info.getRegisterName())) addRegister(info);
+    addIfNotExisting(info);
   }
-  else if(doocsType == DATA_INT || doocsType == DATA_A_INT || doocsType == DATA_A_SHORT || doocsType == DATA_A_LONG ||
-      doocsType == DATA_A_BYTE || doocsType == DATA_IIII) { // integral data types
-    size_t digits;
-    if(doocsType == DATA_A_SHORT) { // 16 bit signed
-      digits = 6;
-    }
-    else if(doocsType == DATA_A_BYTE) { // 8 bit signed
-      digits = 4;
-    }
-    else if(doocsType == DATA_A_LONG) { // 64 bit signed
-      digits = 20;
+  else if(doocsType == DATA_IFFF) {
+    info._field = Field::I;
+    info._dataDescriptor = &DoocsBackendRegisterInfo::getSharedDataDescriptor(doocsType, Field::I);
+    addIfNotExisting(info);
+
+    info._dataDescriptor = &DoocsBackendRegisterInfo::getSharedDataDescriptor(doocsType, Field::F1);
+    for(auto field : {Field::F1, Field::F2, Field::F3}) {
+      info._field = field;
+      addIfNotExisting(info);
     }
-    else { // 32 bit signed
-      digits = 11;
+  }
+  else if(doocsType == DATA_USTR) {
+    // DOOCS reports the length of the string
+    info._length = 1;
+    for(auto field : {Field::I, Field::F1, Field::F2, Field::TM, Field::STR}) {
+      info._field = field;
+      info._dataDescriptor = &DoocsBackendRegisterInfo::getSharedDataDescriptor(doocsType, field);
+      addIfNotExisting(info);
     }
+  }
+  else {
     if(doocsType == DATA_IIII) info._length = 4;
+    if(doocsType == DATA_IMAGE) info._writable = false;
+    addIfNotExisting(info);
+  }
 
-    info.dataDescriptor =
-        ChimeraTK::DataDescriptor(ChimeraTK::DataDescriptor::FundamentalType::numeric, true, true, digits);
-    if(!hasRegister(info.getRegisterName())) addRegister(info);
+  // meta data registers, sharing the names with the property
+  info._length = 1;
+  info.doocsTypeId = DATA_LONG;
+  info._readable = true;
+  info._writable = false;
+  for(auto field : {Field::eventId, Field::timeStamp}) {
+    info._field = field;
+    info._dataDescriptor = &DoocsBackendRegisterInfo::getSharedDataDescriptor(DATA_LONG, field);
+    addIfNotExisting(info);
   }
-  else if(doocsType == DATA_IFFF) {
-    info._name = name + "/I";
-    info.dataDescriptor = ChimeraTK::DataDescriptor(
-        ChimeraTK::DataDescriptor::FundamentalType::numeric, true, true, 11); // 32 bit integer
+}
 
-    DoocsBackendRegisterInfo infoF1(info);
-    infoF1._name = name + "/F1";
-    infoF1.dataDescriptor =
-        ChimeraTK::DataDescriptor(ChimeraTK::DataDescriptor::FundamentalType::numeric, false, true, 320, 300); // float
+/*******************************************************************************************************************/
 
-    DoocsBackendRegisterInfo infoF2(infoF1);
-    infoF2._name = name + "/F2";
+void DoocsBackendRegisterCatalogue::addBackendRegister(const std::string& name, unsigned int length, int doocsType) {
+  DoocsBackendRegisterInfo info;
+  setName(info, name);
+  info._length = length;
+  info.doocsTypeId = doocsType;
+  info._dataDescriptor = &DoocsBackendRegisterInfo::getSharedDataDescriptor(doocsType);
+  info._writable = false;
+  info._isDoocsProperty = false;
+  if(!hasRegister(info.getRegisterName())) addRegister(info);
+}
 
-    DoocsBackendRegisterInfo infoF3(infoF1);
-    infoF3._name = name + "/F3";
+/*******************************************************************************************************************/
 
-    if(!hasRegister(info.getRegisterName())) addRegister(info);
-    if(!hasRegister(infoF1.getRegisterName())) addRegister(infoF1);
-    if(!hasRegister(infoF2.getRegisterName())) addRegister(infoF2);
-    if(!hasRegister(infoF3.getRegisterName())) addRegister(infoF3);
+void DoocsBackendRegisterCatalogue::setName(DoocsBackendRegisterInfo& info, const std::string& name) {
+  auto lastSlash = name.find_last_of('/');
+  if(lastSlash != std::string::npos) {
+    info._location = internLocation(name.substr(0, lastSlash));
+    info._property = std::make_shared<const std::string>(name.substr(lastSlash + 1));
   }
-  else if(doocsType == DATA_IMAGE) {
-    // data type for created accessor is uint8
-    info.dataDescriptor = ChimeraTK::DataDescriptor(
-        ChimeraTK::DataDescriptor::FundamentalType::numeric, true, false, 3, 0, ChimeraTK::DataType::uint8);
-    info._writable = false;
-    if(!hasRegister(info.getRegisterName())) addRegister(info);
+  else {
+    info._location = internLocation("");
+    info._property = std::make_shared<const std::string>(name);
   }
-  else { // floating point data types: always treat like double
-    info.dataDescriptor =
-        ChimeraTK::DataDescriptor(ChimeraTK::DataDescriptor::FundamentalType::numeric, false, true, 320, 300);
-    if(!hasRegister(info.getRegisterName())) addRegister(info);
+}
+
+/*******************************************************************************************************************/
+
+std::shared_ptr<const std::string> DoocsBackendRegisterCatalogue::internLocation(const std::string& location) {
+  auto& interned = _locations[location];
+  if(!interned) {
+    interned = std::make_shared<const std::string>(location);
+  }
+  return interned;
+}
+
+/*******************************************************************************************************************/
+
+std::unique_ptr<ChimeraTK::BackendRegisterCatalogueBase> DoocsBackendRegisterCatalogue::clone() const {
+  auto c = std::make_unique<DoocsBackendRegisterCatalogue>();
+  for(const auto& info : *this) {
+    c->addRegister(info);
+  }
+  c->_isCatalogueComplete = _isCatalogueComplete;
+  c->_locations = _locations;
+  return c;
+}
+
+/*******************************************************************************************************************/
+
+ChimeraTK::RegisterPath DoocsBackendRegisterInfo::getRegisterName() const {
+  auto name = ChimeraTK::RegisterPath(_location ? *_location : std::string());
+  name /= _property ? *_property : std::string();
+  switch(_field) {
+    case Field::none:
+      break;
+    case Field::I:
+      name /= "I";
+      break;
+    case Field::F1:
+      name /= "F1";
+      break;
+    case Field::F2:
+      name /= "F2";
+      break;
+    case Field::F3:
+      name /= "F3";
+      break;
+    case Field::TM:
+      name /= "TM";
+      break;
+    case Field::STR:
+      name /= "STR";
+      break;
+    case Field::eventId:
+      name /= "eventId";
+      break;
+    case Field::timeStamp:
+      name /= "timeStamp";
+      break;
+  }
+  return name;
+}
+
+/*******************************************************************************************************************/
+
+ChimeraTK::AccessModeFlags DoocsBackendRegisterInfo::getSupportedAccessModes() const {
+  if(_zmqAvailable) {
+    return {ChimeraTK::AccessMode::wait_for_new_data};
   }
+  return {};
+}
+
+/*******************************************************************************************************************/
+
+const ChimeraTK::DataDescriptor& DoocsBackendRegisterInfo::getDataDescriptor() const {
+  static const ChimeraTK::DataDescriptor undefined{};
+  return _dataDescriptor ? *_dataDescriptor : undefined;
+}
 
-  DoocsBackendRegisterInfo infoEventId;
-  infoEventId._name = name + "/eventId";
-  infoEventId._writable = false;
-  infoEventId.doocsTypeId = DATA_LONG;
-  infoEventId._length = 1;
-  infoEventId.dataDescriptor =
-      ChimeraTK::DataDescriptor(ChimeraTK::DataDescriptor::FundamentalType::numeric, true, true, 20);
-  infoEventId.accessModeFlags = flags;
-  if(!hasRegister(infoEventId.getRegisterName())) addRegister(infoEventId);
+/*******************************************************************************************************************/
+
+const ChimeraTK::DataDescriptor& DoocsBackendRegisterInfo::getSharedDataDescriptor(int doocsType, Field field) {
+  using ChimeraTK::DataDescriptor;
+  static const DataDescriptor string{DataDescriptor::FundamentalType::string};
+  static const DataDescriptor int8{DataDescriptor::FundamentalType::numeric, true, true, 4};
+  static const DataDescriptor int16{DataDescriptor::FundamentalType::numeric, true, true, 6};
+  static const DataDescriptor int32{DataDescriptor::FundamentalType::numeric, true, true, 11};
+  static const DataDescriptor int64{DataDescriptor::FundamentalType::numeric, true, true, 20};
+  static const DataDescriptor floatingPoint{DataDescriptor::FundamentalType::numeric, false, true, 320, 300};
+  // data type for created accessor is uint8
+  static const DataDescriptor image{
+      DataDescriptor::FundamentalType::numeric, true, false, 3, 0, ChimeraTK::DataType::uint8};
 
-  DoocsBackendRegisterInfo infoTimeStamp;
-  infoTimeStamp._name = name + "/timeStamp";
-  infoTimeStamp.doocsTypeId = DATA_LONG;
-  infoTimeStamp._length = 1;
-  infoTimeStamp.dataDescriptor =
-      ChimeraTK::DataDescriptor(ChimeraTK::DataDescriptor::FundamentalType::numeric, true, true, 20);
-  infoTimeStamp._writable = false;
-  infoTimeStamp.accessModeFlags = flags;
-  if(!hasRegister(infoTimeStamp.getRegisterName())) addRegister(infoTimeStamp);
+  if(field == Field::eventId || field == Field::timeStamp) {
+    return int64;
+  }
+
+  switch(doocsType) {
+    case DATA_TEXT:
+    case DATA_STRING:
+      return string;
+    case DATA_A_BYTE: // 8 bit signed
+      return int8;
+    case DATA_A_SHORT: // 16 bit signed
+      return int16;
+    case DATA_A_LONG: // 64 bit signed
+      return int64;
+    case DATA_INT:
+    case DATA_A_INT:
+    case DATA_IIII: // 32 bit signed
+      return int32;
+    case DATA_IFFF:
+      return field == Field::I ? int32 : floatingPoint;
+    case DATA_USTR:
+      switch(field) {
+        case Field::I:
+          return int32;
+        case Field::F1:
+        case Field::F2:
+          return floatingPoint;
+        case Field::TM:
+          return int64;
+        default:
+          return string;
+      }
+    case DATA_IMAGE:
+      return image;
+    default: // floating point data types: always treat like double
+      return floatingPoint;
+  }
 }
 
 /*******************************************************************************************************************/
@@ -108,3 +228,49 @@ std::unique_ptr<ChimeraTK::BackendRegisterInfoBase> DoocsBackendRegisterInfo::cl
 }
 
 /*******************************************************************************************************************/
+
+DoocsBackendRegisterCatalogueView::DoocsBackendRegisterCatalogueView(
+    std::shared_ptr<const DoocsBackendRegisterCatalogue> catalogue)
+: _catalogue(std::move(catalogue)) {}
+
+/*******************************************************************************************************************/
+
+ChimeraTK::RegisterInfo DoocsBackendRegisterCatalogueView::getRegister(
+    const ChimeraTK::RegisterPath& registerPathName) const {
+  return _catalogue->getRegister(registerPathName);
+}
+
+/*******************************************************************************************************************/
+
+bool DoocsBackendRegisterCatalogueView::hasRegister(const ChimeraTK::RegisterPath& registerPathName) const {
+  return _catalogue->hasRegister(registerPathName);
+}
+
+/*******************************************************************************************************************/
+
+size_t DoocsBackendRegisterCatalogueView::getNumberOfRegisters() const {
+  return _catalogue->getNumberOfRegisters();
+}
+
+/*******************************************************************************************************************/
+
+std::unique_ptr<ChimeraTK::const_RegisterCatalogueImplIterator> DoocsBackendRegisterCatalogueView::
+    getConstIteratorBegin() const {
+  // the iterators stay valid as long as the snapshot lives, which is guaranteed by the RegisterCatalogue holding this
+  return _catalogue->getConstIteratorBegin();
+}
+
+/*******************************************************************************************************************/
+
+std::unique_ptr<ChimeraTK::const_RegisterCatalogueImplIterator> DoocsBackendRegisterCatalogueView::getConstIteratorEnd()
+    const {
+  return _catalogue->getConstIteratorEnd();
+}
+
+/*******************************************************************************************************************/
+
+std::unique_ptr<ChimeraTK::BackendRegisterCatalogueBase> DoocsBackendRegisterCatalogueView::clone() const {
+  return std::make_unique<DoocsBackendRegisterCatalogueView>(_catalogue);
+}
+
+/*******************************************************************************************************************/
@@ -1,7 +1,12 @@
 #include "ZMQSubscriptionManager.h"
 
+#include "DoocsBackendEventBundle.h"
 #include "DoocsBackendRegisterAccessor.h"
 
+#include <algorithm>
+#include <array>
+#include <iostream>
+
 namespace ChimeraTK::DoocsBackendNamespace {
 
   /******************************************************************************************************************/
@@ -45,13 +50,27 @@ namespace ChimeraTK::DoocsBackendNamespace {
     std::unique_lock<std::mutex> listeners_lock(subscriptionMap[path].listeners_mutex);
 
     // add accessor to list of listeners
-    subscriptionMap[path].listeners.push_back(accessor);
+    auto& subscription = subscriptionMap[path];
+    subscription.listeners.push_back(accessor);
+
+    // share the notification buffers with the other listeners
+    if(!subscription.pool) {
+      subscription.pool = DoocsBackendEqDataPool::create(0, accessor->src.type(), accessor->doocsLength);
+    }
+    accessor->_eqDataPool = subscription.pool;
+    updatePoolSize(subscription);
+    updateListenerFlags(subscription);
+
+    // hand off the updates to the decoding workers if requested by the backend
+    if(accessor->_backend->_zmqWorkers > 0) {
+      enableOffload(subscription, accessor->_backend->_zmqWorkers);
+    }
 
     // subscriptionMap is no longer used below this point
     lock.unlock();
 
     // Set flag whether ZMQ is activated for this accessor
-    accessor->isActiveZMQ = accessor->_backend->_asyncReadActivated;
+    accessor->isActiveZMQ = accessor->_backend->_asyncReadActivated.load();
 
     // create subscription if not yet existing. must be done after the previous steps to make sure the initial value
     // is not lost
@@ -74,19 +93,35 @@ namespace ChimeraTK::DoocsBackendNamespace {
     // Poll initial value vie RPC
     doocs::EqData src, dst;
     doocs::EqAdr adr;
-    EqCall eq;
-    adr.adr(path);
-    auto rc = eq.get(&adr, &src, &dst);
+    std::chrono::milliseconds timeout{0};
+    if(!accessors.empty()) {
+      adr = accessors.front()->_backend->_addressCache.get(path);
+      timeout = accessors.front()->getRpcTimeout();
+    }
+    else {
+      adr.adr(path);
+    }
+    DoocsBackendTimedRpc eq(path);
+    auto rc = eq.get(&adr, &src, &dst, timeout);
+    for(auto accessor : accessors) {
+      accessor->_backend->_statistics.recordInitialValuePoll();
+      if(eq.hasTimedOut()) accessor->_backend->_statistics.recordTimeout();
+    }
     if(rc == doocs::TransactionResult::transaction_error || rc == doocs::TransactionResult::transport_error) {
       // communication error: push to queues
       for(auto accessor : accessors) {
-        pushError(accessor, "ZeroMQ connection for " + path + " interrupted: " + dst.get_string());
+        pushError(accessor, "ZeroMQ connection for " + path + " interrupted: " + eq.getErrorMessage(dst));
       }
     }
     else {
       // no communication error: push data
       for(auto accessor : accessors) {
-        accessor->notifications.push_overwrite(dst);
+        if(!accessor->passesChangeFilter(dst)) continue;
+        bool allocated;
+        auto buffer = accessor->_eqDataPool->acquire(allocated);
+        if(allocated) accessor->_backend->_statistics.recordZmqBufferAllocation();
+        *buffer = dst;
+        accessor->notifications.push_overwrite(DoocsBackendNotification{std::move(buffer), {}});
       }
     }
   }
@@ -110,6 +145,8 @@ namespace ChimeraTK::DoocsBackendNamespace {
     // remove accessor from list of listeners
     subscriptionMap[path].listeners.erase(
         std::remove(subscriptionMap[path].listeners.begin(), subscriptionMap[path].listeners.end(), accessor));
+    updatePoolSize(subscriptionMap[path]);
+    updateListenerFlags(subscriptionMap[path]);
 
     // if no listener left, delete the subscription
     if(subscriptionMap[path].listeners.empty()) {
@@ -181,6 +218,55 @@ namespace ChimeraTK::DoocsBackendNamespace {
     doocs::EqAdr ea;
     ea.adr(path);
     dmsg_detach(&ea, nullptr); // nullptr = remove all subscriptions for that address
+
+    // discard updates not yet processed by the decoding worker. The callback is no longer called at this point.
+    Subscription* subscription;
+    {
+      std::unique_lock<std::mutex> lock(subscriptionMap_mutex);
+      subscription = &subscriptionMap[path];
+    }
+    if(subscription->offload) {
+      subscription->worker->cancel(subscription);
+      subscription->ring.clear();
+    }
+  }
+
+  /******************************************************************************************************************/
+
+  void ZMQSubscriptionManager::enableOffload(Subscription& subscription, size_t nWorkers) {
+    // precondition: subscriptionMap_mutex and the subscription's listeners_mutex must be locked
+    while(workers.size() < nWorkers) {
+      workers.push_back(std::make_unique<DecodingWorker>());
+    }
+    if(subscription.offload) return;
+
+    // The type and length of the property are not known here, the buffers adapt with the first updates. They are
+    // allocated when needed, at most one per slot of the ring, one for its overflow slot, one being filled by the
+    // callback and one being processed by the worker.
+    subscription.receivePool = DoocsBackendEqDataPool::create(handOffCapacity + 3, 0, 0);
+    subscription.worker = workers[nextWorker++ % workers.size()].get();
+    subscription.offload.store(true, std::memory_order_release);
+  }
+
+  /******************************************************************************************************************/
+
+  void ZMQSubscriptionManager::updatePoolSize(Subscription& subscription) {
+    size_t nBuffers = 2;
+    for(auto* listener : subscription.listeners) {
+      nBuffers += listener->notifications.size() + 1;
+    }
+    subscription.pool->setMaxBuffers(nBuffers);
+  }
+
+  /******************************************************************************************************************/
+
+  void ZMQSubscriptionManager::updateListenerFlags(Subscription& subscription) {
+    bool tracing = std::any_of(subscription.listeners.begin(), subscription.listeners.end(),
+        [](auto* listener) { return listener->_backend->_latencyTracer.isEnabled(); });
+    subscription.tracing.store(tracing, std::memory_order_relaxed);
+    bool hasThreadSettings = std::any_of(subscription.listeners.begin(), subscription.listeners.end(),
+        [](auto* listener) { return !listener->_backend->_zmqThreadSettings.isEmpty(); });
+    subscription.hasThreadSettings.store(hasThreadSettings, std::memory_order_relaxed);
   }
 
   /******************************************************************************************************************/
@@ -188,12 +274,24 @@ namespace ChimeraTK::DoocsBackendNamespace {
   void ZMQSubscriptionManager::activateAllListeners(DoocsBackend* backend) {
     std::unique_lock<std::mutex> lock(subscriptionMap_mutex);
 
+    // Reset the bundles before activating any listener, so updates received while activating are not discarded due to
+    // the eventIds seen before the deactivation.
+    for(auto& subscription : subscriptionMap) {
+      std::unique_lock<std::mutex> listeners_lock(subscription.second.listeners_mutex);
+      for(auto& listener : subscription.second.listeners) {
+        if(listener->_backend.get() == backend && listener->_bundle) {
+          listener->_bundle->reset();
+        }
+      }
+    }
+
     for(auto& subscription : subscriptionMap) {
       std::unique_lock<std::mutex> listeners_lock(subscription.second.listeners_mutex);
       std::list<DoocsBackendRegisterAccessorBase*> listeners;
       for(auto& listener : subscription.second.listeners) {
         if(listener->_backend.get() == backend) {
           listener->isActiveZMQ = true;
+          listener->resetChangeFilter();
           if(subscription.second.gotInitialValue) {
             // If the DOOCS initial value was already seen by the callback, put listener to list for initial value poll
             listeners.push_back(listener);
@@ -269,10 +367,44 @@ namespace ChimeraTK::DoocsBackendNamespace {
     // obtain pointer to subscription object
     auto* subscription = static_cast<ZMQSubscriptionManager::Subscription*>(self_);
 
+    // Take time stamps for latency tracing first, if any listener uses tracing
+    NotificationTrace trace;
+    if(subscription->tracing.load(std::memory_order_relaxed)) {
+      trace = LatencyTracer::begin(info->sec, info->usec);
+    }
+
     // Make sure the stamp is used from the ZeroMQ header. TODO: Is this really wanted?
     data->time(info->sec, info->usec);
     data->mpnum(info->ident);
 
+    // Apply the CPU affinity and scheduling settings of the first backend which has some (CDD parameters zmqCpus,
+    // zmqSchedPolicy, zmqPriority). The DOOCS library may use the same thread for several subscriptions, hence the
+    // flag is kept per thread. The lock is only taken on the first call of each thread for a subscription with
+    // settings, also if the updates are handed off below.
+    thread_local bool threadSettingsApplied = false;
+    if(!threadSettingsApplied && subscription->hasThreadSettings.load(std::memory_order_relaxed)) {
+      std::lock_guard<std::mutex> lock(subscription->listeners_mutex);
+      for(auto& listener : subscription->listeners) {
+        auto& settings = listener->_backend->_zmqThreadSettings;
+        if(settings.isEmpty()) continue;
+        threadSettingsApplied = true;
+        auto error = settings.applyToCurrentThread();
+        if(!error.empty()) {
+          // cannot throw here, and the thread keeps working with the default settings
+          std::cerr << "DoocsBackend: cannot apply settings to ZeroMQ thread for '" << listener->_path
+                    << "': " << error << std::endl;
+        }
+        break;
+      }
+    }
+
+    // With decoding workers, the DOOCS thread only needs to copy the update once (see handOff()). The lock is only
+    // required for the bookkeeping of the first call.
+    if(subscription->offload.load(std::memory_order_acquire) && subscription->started.load()) {
+      handOff(*subscription, *data, trace);
+      return;
+    }
+
     std::unique_lock<std::mutex> lock(subscription->listeners_mutex);
 
     // As long as we get a callback from ZMQ, we consider it started
@@ -286,29 +418,88 @@ namespace ChimeraTK::DoocsBackendNamespace {
       subscription->zqmThreadId = pthread_self();
     }
 
+    if(subscription->offload) {
+      lock.unlock();
+      handOff(*subscription, *data, trace);
+      return;
+    }
+
+    distribute(*subscription, *data, trace, lock);
+  }
+
+  /******************************************************************************************************************/
+
+  void ZMQSubscriptionManager::distribute(Subscription& subscription, doocs::EqData& data,
+      const NotificationTrace& trace, std::unique_lock<std::mutex>& lock) {
     // check for error
-    if(!doocs::is_system_error(data->error()) && data->error() != eq_errors::no_connection) {
+    if(!doocs::is_system_error(data.error()) && data.error() != eq_errors::no_connection) {
       // Set flag that we have received an initial value. (If the flag is not set, any received value is by
       // definition the initial value.) This must be done independent from listener activation status, because this
       // is to keep track of the DOOCS-provided initial value.
-      if(!subscription->gotInitialValue) subscription->gotInitialValue = true;
+      if(!subscription.gotInitialValue) subscription.gotInitialValue = true;
 
       // data has been received: push the data
-      for(auto& listener : subscription->listeners) {
+      DoocsBackend* lastBackend = nullptr;
+
+      // Buffers converted for listeners with convertOnReceive, shared with further listeners with the same key. The
+      // number is limited to avoid allocations, further keys are converted for each listener.
+      std::array<std::pair<DoocsBackendRegisterAccessorBase*, std::shared_ptr<void>>, 8> converted;
+      size_t nConverted = 0;
+      auto getConverted = [&](DoocsBackendRegisterAccessorBase* listener) -> std::shared_ptr<void> {
+        if(!listener->convertOnReceive.load(std::memory_order_acquire)) return nullptr;
+        for(size_t i = 0; i < nConverted; ++i) {
+          if(converted[i].first->conversionKey == listener->conversionKey) return converted[i].second;
+        }
+        auto buffer = listener->convertReceived(data);
+        if(buffer && nConverted < converted.size()) converted[nConverted++] = {listener, buffer};
+        return buffer;
+      };
+
+      for(auto& listener : subscription.listeners) {
         if(listener->isActiveZMQ) {
+          // keep snapshot for read-modify-writes (listeners of the same backend are usually adjacent)
+          if(listener->_backend.get() != lastBackend) {
+            lastBackend = listener->_backend.get();
+            lastBackend->_snapshotCache.update(
+                listener->_path, data, DoocsBackendSnapshotCache::Source::subscription);
+          }
+
+          if(!listener->passesChangeFilter(data)) {
+            listener->_backend->_statistics.recordZmqUpdate(listener->notifications.read_available());
+            continue;
+          }
+
           // push data to listener queue
-          listener->notifications.push_overwrite(*data);
+          NotificationTrace listenerTrace;
+          if(listener->_backend->_latencyTracer.isEnabled()) {
+            listenerTrace = trace;
+            listenerTrace.enqueued = std::chrono::steady_clock::now();
+          }
+          bool allocated;
+          auto buffer = listener->_eqDataPool->acquire(allocated);
+          if(allocated) listener->_backend->_statistics.recordZmqBufferAllocation();
+          *buffer = data;
+          DoocsBackendNotification notification{std::move(buffer), listenerTrace, getConverted(listener)};
+          if(listener->_bundle) {
+            // the bundle pushes the update once the updates of all its accessors for this eventId are complete
+            listener->_bundle->push(listener, std::move(notification));
+          }
+          else {
+            listener->notifications.push_overwrite(std::move(notification));
+          }
+          listener->_backend->_statistics.recordZmqUpdate(listener->notifications.read_available());
         }
       }
     }
     else {
       // Clear initial value flag: we will get a new initial value from DOOCS after the DOOCS-internal recovery
       // (independent of the backend's error state and recovery!)
-      subscription->gotInitialValue = false;
+      subscription.gotInitialValue = false;
 
       // Push exception to the listeners
-      for(auto& listener : subscription->listeners) {
-        pushError(listener, "ZeroMQ connection interrupted: " + data->get_string());
+      for(auto& listener : subscription.listeners) {
+        listener->_backend->_statistics.recordZmqError();
+        pushError(listener, "ZeroMQ connection interrupted: " + data.get_string());
         lock.unlock();
         listener->_backend->informRuntimeError(listener->_path);
         lock.lock();
@@ -318,4 +509,107 @@ namespace ChimeraTK::DoocsBackendNamespace {
 
   /******************************************************************************************************************/
 
+  void ZMQSubscriptionManager::handOff(
+      Subscription& subscription, doocs::EqData& data, const NotificationTrace& trace) {
+    auto buffer = subscription.receivePool->acquire();
+    *buffer = data;
+    ReceivedUpdate update{std::move(buffer), trace};
+    if(!doocs::is_system_error(data.error()) && data.error() != eq_errors::no_connection) {
+      // If the worker cannot keep up, replace the oldest pending update which did not fit into the ring rather than
+      // blocking the DOOCS thread. The latest update is always delivered, like with the queues of the listeners.
+      auto replaced = subscription.ring.pushLatest(std::move(update));
+      if(replaced > 0) subscription.dropped.fetch_add(replaced, std::memory_order_relaxed);
+    }
+    else if(subscription.ring.hasOverflow() || !subscription.ring.push(std::move(update))) {
+      // errors must not be lost: wait until the worker has made room (and taken the overflow value, to keep the order)
+      subscription.worker->schedule(&subscription);
+      while(subscription.ring.hasOverflow() || !subscription.ring.push(std::move(update))) {
+        std::this_thread::yield();
+      }
+    }
+    subscription.worker->schedule(&subscription);
+  }
+
+  /******************************************************************************************************************/
+
+  void ZMQSubscriptionManager::processHandedOff(Subscription& subscription) {
+    ReceivedUpdate update;
+    while(subscription.ring.pop(update)) {
+      std::unique_lock<std::mutex> lock(subscription.listeners_mutex);
+      auto dropped = subscription.dropped.exchange(0, std::memory_order_relaxed);
+      if(dropped > 0) {
+        DoocsBackend* lastBackend = nullptr;
+        for(auto& listener : subscription.listeners) {
+          if(listener->_backend.get() == lastBackend) continue;
+          lastBackend = listener->_backend.get();
+          lastBackend->_statistics.recordZmqHandOffDropped(dropped);
+        }
+      }
+      distribute(subscription, *update.data, update.trace, lock);
+      lock.unlock();
+      update.data.reset();
+    }
+  }
+
+  /******************************************************************************************************************/
+
+  ZMQSubscriptionManager::DecodingWorker::DecodingWorker() {
+    thread = std::thread([this] { run(); });
+  }
+
+  /******************************************************************************************************************/
+
+  ZMQSubscriptionManager::DecodingWorker::~DecodingWorker() {
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      stop = true;
+    }
+    cv.notify_all();
+    thread.join();
+  }
+
+  /******************************************************************************************************************/
+
+  void ZMQSubscriptionManager::DecodingWorker::schedule(Subscription* subscription) {
+    // Avoid taking the lock if the subscription is queued already. The worker clears the flag before processing the
+    // ring, so an update pushed during the processing will queue the subscription again.
+    if(subscription->scheduled.exchange(true)) return;
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      ready.push_back(subscription);
+    }
+    cv.notify_one();
+  }
+
+  /******************************************************************************************************************/
+
+  void ZMQSubscriptionManager::DecodingWorker::cancel(Subscription* subscription) {
+    std::unique_lock<std::mutex> lock(mutex);
+    ready.erase(std::remove(ready.begin(), ready.end(), subscription), ready.end());
+    doneCv.wait(lock, [&] { return current != subscription; });
+    subscription->scheduled = false;
+  }
+
+  /******************************************************************************************************************/
+
+  void ZMQSubscriptionManager::DecodingWorker::run() {
+    std::unique_lock<std::mutex> lock(mutex);
+    while(true) {
+      cv.wait(lock, [&] { return stop || !ready.empty(); });
+      if(stop) return;
+      current = ready.front();
+      ready.pop_front();
+      lock.unlock();
+
+      current->scheduled = false;
+      processHandedOff(*current);
+
+      lock.lock();
+      current = nullptr;
+      doneCv.notify_all();
+    }
+  }
+
+  /******************************************************************************************************************/
+
 } // namespace ChimeraTK::DoocsBackendNamespace
@@ -11,7 +11,8 @@ eq_dummy::eq_dummy(const EqFctParameters& p)
   prop_someBit("SOME_BIT", 0, &this->_someValue, this), prop_someIntArray("SOME_INT_ARRAY", 42, this),
   prop_someShortArray("SOME_SHORT_ARRAY", 5, this), prop_someLongArray("SOME_LONG_ARRAY", 5, this),
   prop_someFloatArray("SOME_FLOAT_ARRAY", 5, this), prop_someDoubleArray("SOME_DOUBLE_ARRAY", 5, this),
-  prop_someSpectrum("SOME_SPECTRUM", 100, this), prop_someIIII("SOME_IIII", this), prop_someIFFF("SOME_IFFF", this),
+  prop_someByteArray("SOME_BYTE_ARRAY", 5, this), prop_someSpectrum("SOME_SPECTRUM", 100, this),
+  prop_someIIII("SOME_IIII", this), prop_someIFFF("SOME_IFFF", this), prop_someUSTR("SOME_USTR", this),
   prop_someImage("SOME_IMAGE", 640 * 460, this), prop_unsupportedDataType("UNSUPPORTED_DATA_TYPE", this),
   prop_someZMQInt("SOME_ZMQINT", this),
   // counter well below the 10000 used by testUnifiesBackendTest
@@ -73,6 +74,14 @@ void eq_dummy::init() {
   prop_someIFFF.set_mpnum(counter);
   prop_someIFFF.set_tmstmp(startTime, 0);
 
+  for(int i = 0; i < 5; i++) prop_someByteArray.set_value((unsigned char)(50 * i - 100), i);
+  prop_someByteArray.set_mpnum(counter);
+  prop_someByteArray.set_tmstmp(startTime, 0);
+
+  prop_someUSTR.set_value(7, 1.5f, -2.5f, startTime, "some text");
+  prop_someUSTR.set_mpnum(counter);
+  prop_someUSTR.set_tmstmp(startTime, 0);
+
   IMH imh{};
   imh.image_format = TTF2_IMAGE_FORMAT_GRAY;
   imh.bpp = 2;
@@ -136,6 +145,9 @@ void eq_dummy::update() {
   prop_someDoubleArray.set_mpnum(counter);
   prop_someDoubleArray.set_tmstmp(startTime, 0);
 
+  prop_someByteArray.set_mpnum(counter);
+  prop_someByteArray.set_tmstmp(startTime, 0);
+
   prop_someSpectrum.macro_pulse(counter, 0);
   prop_someSpectrum.set_tmstmp(startTime, 0, 0);
 
@@ -145,6 +157,9 @@ void eq_dummy::update() {
   prop_someIFFF.set_mpnum(counter);
   prop_someIFFF.set_tmstmp(startTime, 0);
 
+  prop_someUSTR.set_mpnum(counter);
+  prop_someUSTR.set_tmstmp(startTime, 0);
+
   prop_someImage.set_mpnum(counter);
   prop_someImage.set_tmstmp(startTime, 0);
 
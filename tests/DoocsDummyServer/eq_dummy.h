@@ -23,10 +23,12 @@ class eq_dummy : public EqFct {
   D_longarray prop_someLongArray;
   D_floatarray prop_someFloatArray;
   D_doublearray prop_someDoubleArray;
+  D_bytearray prop_someByteArray;
 
   D_spectrum prop_someSpectrum;
   D_iiii prop_someIIII;
   D_ifff prop_someIFFF;
+  D_ustr prop_someUSTR;
   D_image prop_someImage;
   D_ttii prop_unsupportedDataType;
 
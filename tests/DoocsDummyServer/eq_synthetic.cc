@@ -0,0 +1,163 @@
+#include "eq_synthetic.h"
+
+#include <boost/algorithm/string.hpp>
+
+#include <chrono>
+#include <cstdio>
+#include <iostream>
+#include <sstream>
+
+eq_synthetic::eq_synthetic(const EqFctParameters& p)
+: EqFct(p), prop_nProperties("N_PROPERTIES number of synthetic properties", this),
+  prop_typeMix("TYPE_MIX relative weights of the property types", this),
+  prop_arraySize("ARRAY_SIZE number of elements of array properties", this),
+  prop_nZmqProperties("N_ZMQ_PROPERTIES number of properties published via ZeroMQ", this),
+  prop_zmqRate("ZMQ_RATE updates per second of each ZeroMQ property", this) {}
+
+eq_synthetic::~eq_synthetic() {
+  _stopPublisher = true;
+  if(_publisher.joinable()) _publisher.join();
+}
+
+void eq_synthetic::init() {
+  // parse type mix into a repeating pattern, e.g. "int:2,float:1" -> int, int, float
+  std::vector<std::string> pattern;
+  std::vector<std::string> entries;
+  std::string typeMix = prop_typeMix.value();
+  if(typeMix.empty()) typeMix = "int:1";
+  boost::split(entries, typeMix, boost::is_any_of(", "), boost::token_compress_on);
+  for(const auto& entry : entries) {
+    if(entry.empty()) continue;
+    auto colon = entry.find(':');
+    auto type = entry.substr(0, colon);
+    int weight = colon == std::string::npos ? 1 : std::stoi(entry.substr(colon + 1));
+    for(int i = 0; i < weight; ++i) pattern.push_back(type);
+  }
+
+  size_t nProperties = std::max(prop_nProperties.value(), 0);
+  _properties.reserve(nProperties);
+  for(size_t i = 0; i < nProperties; ++i) {
+    createProperty(i, pattern[i % pattern.size()]);
+  }
+}
+
+void eq_synthetic::createProperty(size_t index, const std::string& type) {
+  char prefix[16];
+  snprintf(prefix, sizeof(prefix), "P%06zu_", index);
+  auto name = std::string(prefix) + boost::to_upper_copy(type);
+  int arraySize = std::max(prop_arraySize.value(), 1);
+  auto base = double(index);
+
+  SyntheticProperty p;
+  p.name = name;
+  if(type == "int") {
+    auto prop = new D_int(name, this);
+    prop->set_value(int(index));
+    p.update = [prop, index](int64_t counter) { prop->set_value(int(index + counter)); };
+    p.property.reset(prop);
+  }
+  else if(type == "float") {
+    auto prop = new D_float(name, this);
+    prop->set_value(float(base));
+    p.update = [prop, base](int64_t counter) { prop->set_value(float(base + double(counter) / 10.)); };
+    p.property.reset(prop);
+  }
+  else if(type == "double") {
+    auto prop = new D_double(name, this);
+    prop->set_value(base);
+    p.update = [prop, base](int64_t counter) { prop->set_value(base + double(counter) / 10.); };
+    p.property.reset(prop);
+  }
+  else if(type == "string") {
+    auto prop = new D_string(name, this);
+    prop->set_value(name);
+    p.update = [prop, name](int64_t counter) { prop->set_value(name + " " + std::to_string(counter)); };
+    p.property.reset(prop);
+  }
+  else if(type == "int_array") {
+    auto prop = new D_intarray(name, arraySize, this);
+    for(int i = 0; i < arraySize; ++i) prop->set_value(int(index) + i, i);
+    p.update = [prop, arraySize](int64_t counter) {
+      for(int i = 0; i < arraySize; ++i) prop->set_value(int(counter) + i, i);
+    };
+    p.property.reset(prop);
+  }
+  else if(type == "float_array") {
+    auto prop = new D_floatarray(name, arraySize, this);
+    for(int i = 0; i < arraySize; ++i) prop->set_value(float(base + i), i);
+    p.update = [prop, arraySize](int64_t counter) {
+      for(int i = 0; i < arraySize; ++i) prop->set_value(float(counter + i), i);
+    };
+    p.property.reset(prop);
+  }
+  else if(type == "double_array") {
+    auto prop = new D_doublearray(name, arraySize, this);
+    for(int i = 0; i < arraySize; ++i) prop->set_value(base + i, i);
+    p.update = [prop, arraySize](int64_t counter) {
+      for(int i = 0; i < arraySize; ++i) prop->set_value(double(counter + i), i);
+    };
+    p.property.reset(prop);
+  }
+  else {
+    std::cout << "eq_synthetic: unknown type '" << type << "' in TYPE_MIX." << std::endl;
+    exit(1);
+  }
+  _properties.push_back(std::move(p));
+}
+
+void eq_synthetic::post_init() {
+  size_t nZmq = std::min(size_t(std::max(prop_nZmqProperties.value(), 0)), _properties.size());
+  for(size_t i = 0; i < nZmq; ++i) {
+    int res = _properties[i].property->set_mode(DMSG_EN);
+    if(res != 0) {
+      std::cout << "Could not enable ZeroMQ messaging for " << _properties[i].name << ". Code: " << res << std::endl;
+      exit(1);
+    }
+  }
+  if(nZmq > 0 && prop_zmqRate.value() > 0) {
+    _publisher = std::thread([this] { publish(); });
+  }
+}
+
+void eq_synthetic::publish() {
+  size_t nZmq = std::min(size_t(prop_nZmqProperties.value()), _properties.size());
+  auto period = std::chrono::nanoseconds(1000000000 / prop_zmqRate.value());
+  auto next = std::chrono::steady_clock::now();
+
+  while(!_stopPublisher) {
+    auto now = std::chrono::system_clock::now().time_since_epoch();
+    auto sec = std::chrono::duration_cast<std::chrono::seconds>(now);
+    auto usec = std::chrono::duration_cast<std::chrono::microseconds>(now - sec);
+
+    lock();
+    set_global_mpnum(_counter);
+    for(size_t i = 0; i < nZmq; ++i) {
+      auto& p = _properties[i];
+      p.update(_counter);
+      p.property->set_mpnum(_counter);
+      p.property->set_tmstmp(sec.count(), usec.count());
+
+      dmsg_info_t db;
+      db.sec = sec.count();
+      db.usec = usec.count();
+      db.ident = _counter;
+      db.stat = 0;
+      p.property->send(&db);
+    }
+    unlock();
+    ++_counter;
+
+    // keep the average rate, but do not try to catch up if we are falling behind
+    next += period;
+    auto current = std::chrono::steady_clock::now();
+    if(next < current) next = current;
+    std::this_thread::sleep_until(next);
+  }
+}
+
+std::vector<std::string> eq_synthetic::getPropertyNames() const {
+  std::vector<std::string> names;
+  names.reserve(_properties.size());
+  for(const auto& p : _properties) names.push_back(p.name);
+  return names;
+}
@@ -0,0 +1,83 @@
+#pragma once
+
+#include <doocs/Server.h>
+
+#include <d_fct.h>
+#include <eq_fct.h>
+
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+/**
+ * Location class with a configurable number of synthetic properties, for load and scale testing. The configuration is
+ * taken from the config file of the server:
+ *
+ * eq_fct_name:  "SYNTHETIC"
+ * eq_fct_type:  11
+ * {
+ * NAME:  "SYNTHETIC"
+ * N_PROPERTIES:  10000
+ * TYPE_MIX:  "int:4,float:2,double:1,string:1,int_array:1,double_array:1"
+ * ARRAY_SIZE:  1000
+ * N_ZMQ_PROPERTIES:  100
+ * ZMQ_RATE:  1000
+ * }
+ *
+ * The properties are created in init(). Their names are of the form P<index>_<TYPE>, e.g. P000042_INT_ARRAY. The
+ * type mix gives relative weights of the types, which are assigned in a fixed, repeating pattern. The first
+ * N_ZMQ_PROPERTIES properties are published via ZeroMQ by a separate thread with ZMQ_RATE updates per second each,
+ * independent of the update() mechanism of the server.
+ *
+ * Supported types in TYPE_MIX: int, float, double, string, int_array, float_array, double_array
+ */
+class eq_synthetic : public EqFct {
+ public:
+  eq_synthetic(const EqFctParameters& p);
+  ~eq_synthetic() override;
+
+  D_int prop_nProperties;
+  D_string prop_typeMix;
+  D_int prop_arraySize;
+  D_int prop_nZmqProperties;
+  D_int prop_zmqRate;
+
+  void init() override;
+  void post_init() override;
+  void update() override {}
+
+  static constexpr int code = 11;
+
+  int fct_code() override { return code; }
+
+  /// Names of the synthetic properties, in the order of creation
+  std::vector<std::string> getPropertyNames() const;
+
+  static std::unique_ptr<doocs::Server> createServer() {
+    auto server = std::make_unique<doocs::Server>("Synthetic DOOCS server");
+    server->register_location_class<eq_synthetic>();
+    return server;
+  }
+
+ private:
+  struct SyntheticProperty {
+    std::string name;
+    std::unique_ptr<D_fct> property;
+    /// update the value for the given counter (called with the location lock held)
+    std::function<void(int64_t)> update;
+  };
+
+  std::vector<SyntheticProperty> _properties;
+
+  void createProperty(size_t index, const std::string& type);
+
+  /// publisher thread for ZeroMQ updates
+  std::thread _publisher;
+  std::atomic<bool> _stopPublisher{false};
+  int64_t _counter{1};
+
+  void publish();
+};
@@ -5,6 +5,8 @@
 #include <boost/test/included/unit_test.hpp>
 
 #include <fstream>
+#include <optional>
+#include <set>
 
 /**********************************************************************************************************************/
 
@@ -78,3 +80,83 @@ BOOST_AUTO_TEST_CASE(testGetAccessorWhileClosed) {
 }
 
 /**********************************************************************************************************************/
+
+BOOST_AUTO_TEST_CASE(testMetaDataRegisters) {
+  // cache file as written by the backend, plus a real property named "eventId"
+  std::string xml = "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
+                    "<catalogue version=\"1.0\">";
+  for(const std::string name : {"/DUMMY", "/DUMMY/eventId", "/DUMMY/timeStamp", "/eventId"}) {
+    xml += "  <register>\n"
+           "    <name>" +
+        name +
+        "</name>\n"
+        "    <length>1</length>\n"
+        "    <access_mode></access_mode>\n"
+        "    <doocs_type_id>1</doocs_type_id>\n"
+        "  </register>\n";
+  }
+  xml += "</catalogue>\n";
+  {
+    std::ofstream o(cacheFile);
+    o << xml;
+  }
+
+  {
+    std::string address = "(doocs:doocs://localhost:212/F/D/L?cacheFile=" + cacheFile + ")";
+    auto d = ChimeraTK::Device(address);
+    auto catalogue = d.getRegisterCatalogue();
+
+    // each property has its meta data registers, the meta data registers in the file do not add further registers
+    std::set<std::string> expected{"/DUMMY", "/DUMMY/eventId", "/DUMMY/timeStamp", "/eventId", "/eventId/eventId",
+        "/eventId/timeStamp"};
+    std::set<std::string> names;
+    for(const auto& info : catalogue) {
+      names.insert(std::string(info.getRegisterName()));
+      BOOST_CHECK(catalogue.hasRegister(info.getRegisterName()));
+    }
+    BOOST_CHECK(names == expected);
+    BOOST_CHECK_EQUAL(catalogue.getNumberOfRegisters(), expected.size());
+    BOOST_CHECK(!catalogue.hasRegister("/NOT_EXISTING/eventId"));
+
+    auto info = catalogue.getRegister("/DUMMY/eventId");
+    BOOST_CHECK(info.getRegisterName() == "/DUMMY/eventId");
+    BOOST_CHECK_EQUAL(info.getNumberOfElements(), 1);
+    BOOST_CHECK(info.isReadable());
+    BOOST_CHECK(!info.isWriteable());
+    BOOST_CHECK(info.getDataDescriptor().fundamentalType() == ChimeraTK::DataDescriptor::FundamentalType::numeric);
+
+    // the real property keeps its own data type
+    BOOST_CHECK(catalogue.getRegister("/eventId").isWriteable());
+  }
+
+  deleteFile(cacheFile);
+}
+
+/**********************************************************************************************************************/
+
+BOOST_AUTO_TEST_CASE(testCatalogueSharedSnapshot) {
+  generateCacheFile();
+
+  std::optional<ChimeraTK::RegisterCatalogue> kept;
+  {
+    std::string address = "(doocs:doocs://localhost:212/F/D/L?cacheFile=" + cacheFile + ")";
+    auto d = ChimeraTK::Device(address);
+    auto catalogue1 = d.getRegisterCatalogue();
+    auto catalogue2 = d.getRegisterCatalogue();
+    BOOST_CHECK_EQUAL(catalogue1.getNumberOfRegisters(), catalogue2.getNumberOfRegisters());
+    kept.emplace(catalogue1);
+  }
+
+  // the snapshot must stay valid after the backend is gone
+  BOOST_CHECK(kept->hasRegister("/DUMMY"));
+  size_t n = 0;
+  for(auto& info : *kept) {
+    BOOST_CHECK(info.getRegisterName() == "/DUMMY");
+    ++n;
+  }
+  BOOST_CHECK_EQUAL(n, 1);
+
+  deleteFile(cacheFile);
+}
+
+/**********************************************************************************************************************/
@@ -6,6 +6,10 @@
  */
 #define BOOST_TEST_MODULE testDoocsBackend
 
+#include "DoocsBackend.h"
+#include "DoocsBackendRegisterAccessor.h"
+#include "DoocsBackendTimedRpc.h"
+#include "DoocsBackendTypeDispatch.h"
 #include "eq_dummy.h"
 
 #include <ChimeraTK/CopyRegisterDecorator.h>
@@ -771,6 +775,136 @@ BOOST_AUTO_TEST_CASE(testIFFF) {
 
 /**********************************************************************************************************************/
 
+BOOST_AUTO_TEST_CASE(testUSTR) {
+  ChimeraTK::Device device;
+  device.open(DoocsLauncher::DoocsServer1);
+
+  // check catalogue
+  auto catalogue = device.getRegisterCatalogue();
+  BOOST_TEST(!catalogue.hasRegister("MYDUMMY/SOME_USTR"));
+  auto regI = catalogue.getRegister("MYDUMMY/SOME_USTR/I");
+  auto regF1 = catalogue.getRegister("MYDUMMY/SOME_USTR/F1");
+  auto regTM = catalogue.getRegister("MYDUMMY/SOME_USTR/TM");
+  auto regSTR = catalogue.getRegister("MYDUMMY/SOME_USTR/STR");
+  BOOST_TEST(regI.getDataDescriptor().isIntegral());
+  BOOST_TEST(regI.getDataDescriptor().nDigits() == 11);
+  BOOST_TEST(!regF1.getDataDescriptor().isIntegral());
+  BOOST_TEST(regTM.getDataDescriptor().isIntegral());
+  BOOST_TEST(regTM.getDataDescriptor().nDigits() == 20);
+  BOOST_TEST(regSTR.getDataDescriptor().fundamentalType() == DataDescriptor::FundamentalType::string);
+
+  // the property cannot be accessed as a whole, the string field only as string
+  BOOST_CHECK_THROW(device.getScalarRegisterAccessor<int>("MYDUMMY/SOME_USTR"), ChimeraTK::logic_error);
+  BOOST_CHECK_THROW(device.getScalarRegisterAccessor<int>("MYDUMMY/SOME_USTR/STR"), ChimeraTK::logic_error);
+
+  auto acc_I = device.getScalarRegisterAccessor<int>("MYDUMMY/SOME_USTR/I");
+  auto acc_F1 = device.getScalarRegisterAccessor<float>("MYDUMMY/SOME_USTR/F1");
+  auto acc_F2 = device.getScalarRegisterAccessor<float>("MYDUMMY/SOME_USTR/F2");
+  auto acc_TM = device.getScalarRegisterAccessor<int64_t>("MYDUMMY/SOME_USTR/TM");
+  auto acc_STR = device.getScalarRegisterAccessor<std::string>("MYDUMMY/SOME_USTR/STR");
+
+  // read
+  acc_I.read();
+  BOOST_CHECK_EQUAL(int(acc_I), 7);
+  acc_F1.read();
+  BOOST_CHECK_CLOSE(float(acc_F1), 1.5, 0.00001);
+  acc_F2.read();
+  BOOST_CHECK_CLOSE(float(acc_F2), -2.5, 0.00001);
+  acc_TM.read();
+  BOOST_CHECK_EQUAL(int64_t(acc_TM), 1584020594);
+  acc_STR.read();
+  BOOST_CHECK_EQUAL(std::string(acc_STR), "some text");
+
+  // write single fields, the others must be preserved
+  acc_STR = "other text";
+  acc_STR.write();
+  acc_F2 = 42.5;
+  acc_F2.write();
+
+  acc_I.read();
+  BOOST_CHECK_EQUAL(int(acc_I), 7);
+  acc_F1.read();
+  BOOST_CHECK_CLOSE(float(acc_F1), 1.5, 0.00001);
+  acc_F2.read();
+  BOOST_CHECK_CLOSE(float(acc_F2), 42.5, 0.00001);
+  acc_TM.read();
+  BOOST_CHECK_EQUAL(int64_t(acc_TM), 1584020594);
+  acc_STR.read();
+  BOOST_CHECK_EQUAL(std::string(acc_STR), "other text");
+
+  // fields in one TransferGroup share a single RPC call
+  TransferGroup group;
+  group.addAccessor(acc_I);
+  group.addAccessor(acc_STR);
+  acc_I = 12;
+  acc_STR = "group";
+  group.write();
+  acc_I = 0;
+  acc_STR = "";
+  group.read();
+  BOOST_CHECK_EQUAL(int(acc_I), 12);
+  BOOST_CHECK_EQUAL(std::string(acc_STR), "group");
+  acc_F2.read();
+  BOOST_CHECK_CLOSE(float(acc_F2), 42.5, 0.00001);
+
+  device.close();
+}
+
+/**********************************************************************************************************************/
+
+BOOST_AUTO_TEST_CASE(testByteArray) {
+  ChimeraTK::Device device;
+  device.open(DoocsLauncher::DoocsServer1);
+
+  auto catalogue = device.getRegisterCatalogue();
+  auto reg = catalogue.getRegister("MYDUMMY/SOME_BYTE_ARRAY");
+  BOOST_TEST(reg.getNumberOfElements() == 5);
+  BOOST_TEST(reg.getDataDescriptor().isIntegral());
+  BOOST_TEST(reg.getDataDescriptor().isSigned());
+
+  // int8: raw copy
+  auto acc_int8 = device.getOneDRegisterAccessor<int8_t>("MYDUMMY/SOME_BYTE_ARRAY");
+  acc_int8.read();
+  BOOST_TEST(std::vector<int8_t>(acc_int8) == std::vector<int8_t>({-100, -50, 0, 50, 100}),
+      boost::test_tools::per_element());
+
+  // uint8: converted with clamping, negative values are read as 0
+  auto acc_uint8 = device.getOneDRegisterAccessor<uint8_t>("MYDUMMY/SOME_BYTE_ARRAY");
+  acc_uint8.read();
+  BOOST_TEST(std::vector<uint8_t>(acc_uint8) == std::vector<uint8_t>({0, 0, 0, 50, 100}),
+      boost::test_tools::per_element());
+
+  // other types: converted, also for slices
+  auto acc_double = device.getOneDRegisterAccessor<double>("MYDUMMY/SOME_BYTE_ARRAY", 3, 1);
+  acc_double.read();
+  BOOST_TEST(std::vector<double>(acc_double) == std::vector<double>({-50., 0., 50.}), boost::test_tools::per_element());
+
+  // write
+  acc_int8 = std::vector<int8_t>({1, -2, 3, -4, 5});
+  acc_int8.write();
+  acc_double = std::vector<double>({20., -30., 40.});
+  acc_double.write();
+  acc_int8.read();
+  BOOST_TEST(std::vector<int8_t>(acc_int8) == std::vector<int8_t>({1, 20, -30, 40, 5}),
+      boost::test_tools::per_element());
+
+  // negative values through uint8, and uint8 values above the range of the signed bytes are clamped
+  acc_int8 = std::vector<int8_t>({-1, -128, 127, 0, 1});
+  acc_int8.write();
+  acc_uint8.read();
+  BOOST_TEST(std::vector<uint8_t>(acc_uint8) == std::vector<uint8_t>({0, 0, 127, 0, 1}),
+      boost::test_tools::per_element());
+  acc_uint8 = std::vector<uint8_t>({255, 128, 127, 2, 0});
+  acc_uint8.write();
+  acc_int8.read();
+  BOOST_TEST(std::vector<int8_t>(acc_int8) == std::vector<int8_t>({127, 127, 127, 2, 0}),
+      boost::test_tools::per_element());
+
+  device.close();
+}
+
+/**********************************************************************************************************************/
+
 BOOST_AUTO_TEST_CASE(testImage) {
   ChimeraTK::Device device;
   device.open(DoocsLauncher::DoocsServer1);
@@ -1740,3 +1874,689 @@ BOOST_AUTO_TEST_CASE(testEventIdMapping) {
 }
 
 /**********************************************************************************************************************/
+
+BOOST_AUTO_TEST_CASE(testStatistics) {
+  // statistics registers are only available if enabled in the CDD
+  {
+    ChimeraTK::Device device;
+    device.open(DoocsLauncher::DoocsServer1);
+    BOOST_TEST(!device.getRegisterCatalogue().hasRegister("/_stats/rpc_read_count"));
+    BOOST_CHECK_THROW(device.getScalarRegisterAccessor<int64_t>("/_stats/rpc_read_count"), ChimeraTK::logic_error);
+  }
+
+  ChimeraTK::Device device;
+  device.open("(doocs:doocs://localhost:" + DoocsLauncher::rpc_no + "/F/D?statistics=1)");
+  auto catalogue = device.getRegisterCatalogue();
+  BOOST_TEST(catalogue.hasRegister("/_stats/rpc_read_count"));
+  BOOST_TEST(catalogue.hasRegister("/_stats/rpc_latency_us"));
+  BOOST_TEST(!catalogue.hasRegister("/_stats/rpc_read_count/eventId"));
+  BOOST_TEST(!catalogue.getRegister("/_stats/rpc_read_count").isWriteable());
+
+  auto readCount = device.getScalarRegisterAccessor<int64_t>("/_stats/rpc_read_count");
+  auto writeCount = device.getScalarRegisterAccessor<int64_t>("/_stats/rpc_write_count");
+  auto latency = device.getOneDRegisterAccessor<int64_t>("/_stats/rpc_latency_us");
+  auto limits = device.getOneDRegisterAccessor<int64_t>("/_stats/rpc_latency_bucket_limits_us");
+  BOOST_TEST(latency.getNElements() == limits.getNElements());
+  BOOST_TEST(readCount.isReadOnly());
+  BOOST_CHECK_THROW(readCount.write(), ChimeraTK::logic_error);
+  BOOST_TEST(readCount.getHighLevelImplElement()->getExceptionBackend() == device.getBackend());
+
+  readCount.read();
+  writeCount.read();
+  latency.read();
+  int64_t reads = readCount;
+  int64_t writes = writeCount;
+  int64_t calls = 0;
+  for(auto bucket : latency) calls += bucket;
+
+  auto acc = device.getScalarRegisterAccessor<int32_t>("MYDUMMY/SOME_INT");
+  acc.read();
+  acc.read();
+  acc.write();
+
+  readCount.read();
+  writeCount.read();
+  latency.read();
+  BOOST_CHECK_EQUAL(int64_t(readCount), reads + 2);
+  BOOST_CHECK_EQUAL(int64_t(writeCount), writes + 1);
+  int64_t callsAfter = 0;
+  for(auto bucket : latency) callsAfter += bucket;
+  BOOST_CHECK_EQUAL(callsAfter, calls + 3);
+}
+
+/**********************************************************************************************************************/
+
+BOOST_AUTO_TEST_CASE(testAsyncWrite) {
+  ChimeraTK::Device device;
+  device.open("(doocs:doocs://localhost:" + DoocsLauncher::rpc_no + "/F/D?asyncWrite=1&statistics=1)");
+
+  auto acc = device.getScalarRegisterAccessor<int32_t>("MYDUMMY/SOME_INT");
+  auto coalesced = device.getScalarRegisterAccessor<int64_t>("/_stats/async_write_coalesced_count");
+
+  // a burst of writes: only the last value is guaranteed to arrive, a read waits for the pending write
+  for(int32_t i = 0; i < 1000; ++i) {
+    acc = i;
+    acc.write();
+  }
+  acc.read();
+  BOOST_CHECK_EQUAL(int32_t(acc), 999);
+  BOOST_TEST(DoocsServerTestHelper::doocsGet<int>("//MYDUMMY/SOME_INT") == 999);
+  coalesced.read();
+  // the writes are issued much faster than the RPC calls complete
+  BOOST_TEST(int64_t(coalesced) > 0);
+  BOOST_TEST(int64_t(coalesced) < 1000);
+
+  // partial writes of the same property must not overwrite each other (read-modify-write sees pending writes)
+  auto partial1 = device.getOneDRegisterAccessor<int32_t>("MYDUMMY/SOME_INT_ARRAY", 2, 0);
+  auto partial2 = device.getOneDRegisterAccessor<int32_t>("MYDUMMY/SOME_INT_ARRAY", 2, 2);
+  partial1 = {11, 12};
+  partial2 = {13, 14};
+  partial1.write();
+  partial2.write();
+  device.close();
+  auto array = DoocsServerTestHelper::doocsGetArray<int>("//MYDUMMY/SOME_INT_ARRAY");
+  BOOST_CHECK_EQUAL(array[0], 11);
+  BOOST_CHECK_EQUAL(array[1], 12);
+  BOOST_CHECK_EQUAL(array[2], 13);
+  BOOST_CHECK_EQUAL(array[3], 14);
+
+  // writes rejected because the property is read-only need no recovery, the accessor becomes read-only instead
+  device.open();
+  auto readOnly = device.getScalarRegisterAccessor<int32_t>("MYDUMMY/SOME_RO_INT");
+  readOnly.write();
+  readOnly.read(); // waits until the write has been sent
+  BOOST_TEST(device.isFunctional());
+  BOOST_CHECK_THROW(readOnly.write(), ChimeraTK::logic_error);
+  BOOST_TEST(!readOnly.isWriteable());
+  auto readOnly2 = device.getScalarRegisterAccessor<int32_t>("MYDUMMY/SOME_RO_INT");
+  BOOST_CHECK_THROW(readOnly2.write(), ChimeraTK::logic_error);
+  BOOST_TEST(device.isFunctional());
+  acc = 42;
+  acc.write();
+  device.close();
+  BOOST_TEST(DoocsServerTestHelper::doocsGet<int>("//MYDUMMY/SOME_INT") == 42);
+}
+
+/**********************************************************************************************************************/
+
+BOOST_AUTO_TEST_CASE(testReadModifyWriteSnapshot) {
+  auto cdd = "(doocs:doocs://localhost:" + DoocsLauncher::rpc_no + "/F/D?statistics=1";
+
+  for(bool useSnapshot : {false, true}) {
+    ChimeraTK::Device device;
+    device.open(cdd + (useSnapshot ? "&rmwMaxAge=60000)" : ")"));
+    auto readCount = device.getScalarRegisterAccessor<int64_t>("/_stats/rpc_read_count");
+
+    auto partial = device.getOneDRegisterAccessor<int32_t>("MYDUMMY/SOME_INT_ARRAY", 2, 3);
+    auto field = device.getScalarRegisterAccessor<float>("MYDUMMY/SOME_IFFF/F2");
+    auto full = device.getOneDRegisterAccessor<int32_t>("MYDUMMY/SOME_INT_ARRAY");
+    full.read();
+    auto ifff = device.getScalarRegisterAccessor<int32_t>("MYDUMMY/SOME_IFFF/I");
+    ifff.read();
+    int32_t iBefore = ifff;
+
+    // read-modify-writes: with a recent snapshot no read is required
+    readCount.read();
+    int64_t reads = readCount;
+    partial = {23, 24};
+    partial.write();
+    partial = {25, 26};
+    partial.write();
+    field = 4.5;
+    field.write();
+    readCount.read();
+    BOOST_CHECK_EQUAL(int64_t(readCount), reads + (useSnapshot ? 0 : 3));
+
+    // the result is the same in both cases
+    auto array = DoocsServerTestHelper::doocsGetArray<int>("//MYDUMMY/SOME_INT_ARRAY");
+    full.read();
+    for(size_t i = 0; i < full.getNElements(); ++i) {
+      if(i == 3) {
+        BOOST_CHECK_EQUAL(array[i], 25);
+      }
+      else if(i == 4) {
+        BOOST_CHECK_EQUAL(array[i], 26);
+      }
+      else {
+        BOOST_CHECK_EQUAL(array[i], full[i]);
+      }
+    }
+    auto f2 = device.getScalarRegisterAccessor<float>("MYDUMMY/SOME_IFFF/F2");
+    f2.read();
+    BOOST_CHECK_CLOSE(float(f2), 4.5, 0.001);
+    ifff.read();
+    BOOST_CHECK_EQUAL(int32_t(ifff), iBefore);
+  }
+}
+
+/**********************************************************************************************************************/
+
+BOOST_AUTO_TEST_CASE(testSnapshotOrdering) {
+  DoocsBackendSnapshotCache cache(std::chrono::seconds(60));
+  using Source = DoocsBackendSnapshotCache::Source;
+  auto make = [](int value) {
+    doocs::EqData data;
+    data.set(value);
+    return data;
+  };
+  auto value = [&] {
+    doocs::EqData data;
+    BOOST_REQUIRE(cache.get("//A/B", data));
+    return data.get_int();
+  };
+
+  cache.update("//A/B", make(1), Source::subscription);
+  BOOST_TEST(value() == 1);
+
+  // subscription updates are ignored while a write is in flight
+  cache.beginWrite("//A/B");
+  cache.update("//A/B", make(2), Source::subscription);
+  BOOST_TEST(value() == 1);
+  cache.update("//A/B", make(3), Source::write);
+  cache.endWrite("//A/B", true);
+  BOOST_TEST(value() == 3);
+
+  // an update carrying the value from before the write arrives late: it must not revert the written value
+  cache.update("//A/B", make(2), Source::subscription);
+  BOOST_TEST(value() == 3);
+
+  // RPC reads replace the snapshot of a write
+  cache.update("//A/B", make(4), Source::read);
+  BOOST_TEST(value() == 4);
+  cache.update("//A/B", make(5), Source::subscription);
+  BOOST_TEST(value() == 5);
+
+  // failed writes remove the snapshot
+  cache.beginWrite("//A/B");
+  cache.endWrite("//A/B", false);
+  doocs::EqData data;
+  BOOST_TEST(!cache.get("//A/B", data));
+}
+
+/**********************************************************************************************************************/
+
+BOOST_AUTO_TEST_CASE(testIFFFTransferGroup) {
+  ChimeraTK::Device device;
+  device.open("(doocs:doocs://localhost:" + DoocsLauncher::rpc_no + "/F/D?statistics=1)");
+  auto readCount = device.getScalarRegisterAccessor<int64_t>("/_stats/rpc_read_count");
+  auto writeCount = device.getScalarRegisterAccessor<int64_t>("/_stats/rpc_write_count");
+
+  auto acc_I = device.getScalarRegisterAccessor<int>("MYDUMMY/SOME_IFFF/I");
+  auto acc_F1 = device.getScalarRegisterAccessor<float>("MYDUMMY/SOME_IFFF/F1");
+  auto acc_F2 = device.getScalarRegisterAccessor<float>("MYDUMMY/SOME_IFFF/F2");
+  auto acc_F3 = device.getScalarRegisterAccessor<float>("MYDUMMY/SOME_IFFF/F3");
+
+  TransferGroup group;
+  group.addAccessor(acc_I);
+  group.addAccessor(acc_F1);
+  group.addAccessor(acc_F2);
+  group.addAccessor(acc_F3);
+
+  auto counts = [&] {
+    readCount.read();
+    writeCount.read();
+    return std::make_pair(int64_t(readCount), int64_t(writeCount));
+  };
+
+  // all fields are read with a single RPC call
+  auto before = counts();
+  group.read();
+  auto after = counts();
+  BOOST_CHECK_EQUAL(after.first, before.first + 1);
+  BOOST_CHECK_EQUAL(after.second, before.second);
+
+  // all fields are written with a single RPC call, no read-modify-write required
+  acc_I = 17;
+  acc_F1 = 1.5;
+  acc_F2 = 2.5;
+  acc_F3 = 3.5;
+  before = counts();
+  group.write();
+  after = counts();
+  BOOST_CHECK_EQUAL(after.first, before.first);
+  BOOST_CHECK_EQUAL(after.second, before.second + 1);
+
+  auto check_I = device.getScalarRegisterAccessor<int>("MYDUMMY/SOME_IFFF/I");
+  auto check_F1 = device.getScalarRegisterAccessor<float>("MYDUMMY/SOME_IFFF/F1");
+  auto check_F2 = device.getScalarRegisterAccessor<float>("MYDUMMY/SOME_IFFF/F2");
+  auto check_F3 = device.getScalarRegisterAccessor<float>("MYDUMMY/SOME_IFFF/F3");
+  check_I.read();
+  check_F1.read();
+  check_F2.read();
+  check_F3.read();
+  BOOST_CHECK_EQUAL(int(check_I), 17);
+  BOOST_CHECK_CLOSE(float(check_F1), 1.5, 0.00001);
+  BOOST_CHECK_CLOSE(float(check_F2), 2.5, 0.00001);
+  BOOST_CHECK_CLOSE(float(check_F3), 3.5, 0.00001);
+
+  // writing a single field outside the group still preserves the other fields
+  check_F2 = 4.5;
+  check_F2.write();
+  group.read();
+  BOOST_CHECK_EQUAL(int(acc_I), 17);
+  BOOST_CHECK_CLOSE(float(acc_F1), 1.5, 0.00001);
+  BOOST_CHECK_CLOSE(float(acc_F2), 4.5, 0.00001);
+  BOOST_CHECK_CLOSE(float(acc_F3), 3.5, 0.00001);
+}
+
+/**********************************************************************************************************************/
+
+BOOST_AUTO_TEST_CASE(testArraySlicesTransferGroup) {
+  ChimeraTK::Device device;
+  device.open("(doocs:doocs://localhost:" + DoocsLauncher::rpc_no + "/F/D?statistics=1)");
+  auto readCount = device.getScalarRegisterAccessor<int64_t>("/_stats/rpc_read_count");
+  auto writeCount = device.getScalarRegisterAccessor<int64_t>("/_stats/rpc_write_count");
+  auto counts = [&] {
+    readCount.read();
+    writeCount.read();
+    return std::make_pair(int64_t(readCount), int64_t(writeCount));
+  };
+
+  std::vector<int> expected(42);
+  for(int i = 0; i < 42; ++i) expected[i] = 1000 + i;
+  auto whole = device.getOneDRegisterAccessor<int32_t>("MYDUMMY/SOME_INT_ARRAY");
+  whole = expected;
+  whole.write();
+
+  // slices used on their own transfer directly, without a raw element for the whole property
+  {
+    auto slice = device.getOneDRegisterAccessor<int32_t>("MYDUMMY/SOME_INT_ARRAY", 5, 20);
+    auto impl = boost::dynamic_pointer_cast<DoocsBackendRegisterAccessorBase>(slice.getHighLevelImplElement());
+    BOOST_REQUIRE(impl);
+    slice.read();
+    for(size_t i = 0; i < 5; ++i) BOOST_CHECK_EQUAL(slice[i], expected[20 + i]);
+    for(size_t i = 0; i < 5; ++i) slice[i] = expected[20 + i] = 500 + int(i);
+    slice.write();
+    auto server = DoocsServerTestHelper::doocsGetArray<int>("//MYDUMMY/SOME_INT_ARRAY");
+    BOOST_CHECK_EQUAL_COLLECTIONS(server.begin(), server.end(), expected.begin(), expected.end());
+    BOOST_TEST(!impl->_rawElement);
+  }
+
+  // slices not covering the entire array
+  {
+    auto head = device.getOneDRegisterAccessor<int32_t>("MYDUMMY/SOME_INT_ARRAY", 10, 0);
+    auto middle = device.getOneDRegisterAccessor<int32_t>("MYDUMMY/SOME_INT_ARRAY", 5, 20);
+    auto tail = device.getOneDRegisterAccessor<int32_t>("MYDUMMY/SOME_INT_ARRAY", 2, 40);
+    TransferGroup group;
+    group.addAccessor(head);
+    group.addAccessor(middle);
+    group.addAccessor(tail);
+
+    // the property is read only once for all slices
+    auto before = counts();
+    group.read();
+    auto after = counts();
+    BOOST_CHECK_EQUAL(after.first, before.first + 1);
+    for(size_t i = 0; i < 10; ++i) BOOST_CHECK_EQUAL(head[i], expected[i]);
+    for(size_t i = 0; i < 5; ++i) BOOST_CHECK_EQUAL(middle[i], expected[20 + i]);
+    for(size_t i = 0; i < 2; ++i) BOOST_CHECK_EQUAL(tail[i], expected[40 + i]);
+
+    // one read-modify-write for all slices
+    for(size_t i = 0; i < 10; ++i) head[i] = expected[i] = -int(i);
+    for(size_t i = 0; i < 5; ++i) middle[i] = expected[20 + i] = -20 - int(i);
+    for(size_t i = 0; i < 2; ++i) tail[i] = expected[40 + i] = -40 - int(i);
+    before = counts();
+    group.write();
+    after = counts();
+    BOOST_CHECK_EQUAL(after.first, before.first + 1);
+    BOOST_CHECK_EQUAL(after.second, before.second + 1);
+    auto server = DoocsServerTestHelper::doocsGetArray<int>("//MYDUMMY/SOME_INT_ARRAY");
+    BOOST_CHECK_EQUAL_COLLECTIONS(server.begin(), server.end(), expected.begin(), expected.end());
+  }
+
+  // slices covering the entire array: no read required for writing
+  {
+    auto first = device.getOneDRegisterAccessor<int32_t>("MYDUMMY/SOME_INT_ARRAY", 21, 0);
+    auto second = device.getOneDRegisterAccessor<int32_t>("MYDUMMY/SOME_INT_ARRAY", 21, 21);
+    TransferGroup group;
+    group.addAccessor(first);
+    group.addAccessor(second);
+    for(size_t i = 0; i < 21; ++i) first[i] = expected[i] = 7 * int(i);
+    for(size_t i = 0; i < 21; ++i) second[i] = expected[21 + i] = 7 * int(21 + i);
+    auto before = counts();
+    group.write();
+    auto after = counts();
+    BOOST_CHECK_EQUAL(after.first, before.first);
+    BOOST_CHECK_EQUAL(after.second, before.second + 1);
+    auto server = DoocsServerTestHelper::doocsGetArray<int>("//MYDUMMY/SOME_INT_ARRAY");
+    BOOST_CHECK_EQUAL_COLLECTIONS(server.begin(), server.end(), expected.begin(), expected.end());
+  }
+}
+
+/**********************************************************************************************************************/
+
+BOOST_AUTO_TEST_CASE(testConnectionPrewarm) {
+  ChimeraTK::Device device("(doocs:doocs://localhost:" + DoocsLauncher::rpc_no + "/F/D?statistics=1)");
+  auto backend = boost::dynamic_pointer_cast<DoocsBackend>(device.getBackend());
+  BOOST_REQUIRE(backend);
+
+  // accessors created before open() register their addresses
+  auto scalar = device.getScalarRegisterAccessor<int32_t>("MYDUMMY/SOME_INT");
+  auto array = device.getOneDRegisterAccessor<int32_t>("MYDUMMY/SOME_INT_ARRAY");
+  auto locations = backend->_addressCache.getLocationAddresses();
+  BOOST_REQUIRE_EQUAL(locations.size(), 1);
+  BOOST_TEST(locations[0].find("/MYDUMMY/") != std::string::npos);
+
+  // open() connects to the location (one RPC read per location), transfers work as usual afterwards
+  DoocsServerTestHelper::doocsSet("//MYDUMMY/SOME_INT", 77);
+  auto readCount = backend->_statistics.get("rpc_read_count")[0];
+  device.open();
+  BOOST_TEST(backend->_statistics.get("rpc_read_count")[0] == readCount + 1);
+  scalar.read();
+  BOOST_TEST(int32_t(scalar) == 77);
+  scalar = 78;
+  scalar.write();
+  BOOST_TEST(DoocsServerTestHelper::doocsGet<int>("//MYDUMMY/SOME_INT") == 78);
+
+  // also after re-opening
+  device.close();
+  readCount = backend->_statistics.get("rpc_read_count")[0];
+  device.open();
+  BOOST_TEST(backend->_statistics.get("rpc_read_count")[0] == readCount + 1);
+  array.read();
+  auto server = DoocsServerTestHelper::doocsGetArray<int>("//MYDUMMY/SOME_INT_ARRAY");
+  BOOST_CHECK_EQUAL_COLLECTIONS(array.begin(), array.end(), server.begin(), server.end());
+  device.close();
+}
+
+/**********************************************************************************************************************/
+
+BOOST_AUTO_TEST_CASE(testRecoveryProbe) {
+  BOOST_CHECK_THROW(ChimeraTK::Device("(doocs:doocs://localhost:" + DoocsLauncher::rpc_no + "/F/D?recoveryProbe=x)"),
+      ChimeraTK::logic_error);
+
+  ChimeraTK::Device device("(doocs:doocs://localhost:" + DoocsLauncher::rpc_no + "/F/D?recoveryProbe=3000)");
+  auto backend = boost::dynamic_pointer_cast<DoocsBackend>(device.getBackend());
+  BOOST_REQUIRE(backend);
+  auto scalar = device.getScalarRegisterAccessor<int32_t>("MYDUMMY/SOME_INT");
+
+  // all locations respond
+  device.open();
+  BOOST_TEST(device.isFunctional());
+  scalar.read();
+  device.close();
+
+  // obtaining an address alone does not register it, only accessors do
+  backend->_addressCache.get("doocs://localhost:1/F/D/NOWHERE/PROPERTY");
+  device.open();
+  BOOST_TEST(device.isFunctional());
+  device.close();
+
+  // accessors for non-existing properties are not registered
+  BOOST_CHECK_THROW(device.getScalarRegisterAccessor<int32_t>("MYDUMMY/NOT_EXISTING"), ChimeraTK::logic_error);
+  BOOST_TEST(backend->_addressCache.getLocationAddresses().size() == 1);
+
+  {
+    // simulate an accessor for a server which is down (no RPC server with this number on localhost)
+    auto registration = backend->_addressCache.registerAddress("doocs://localhost:1/F/D/NOWHERE/PROPERTY");
+    BOOST_TEST(backend->_addressCache.getLocationAddresses().size() == 2);
+    BOOST_CHECK_THROW(device.open(), ChimeraTK::runtime_error);
+    BOOST_TEST(!device.isFunctional());
+    BOOST_CHECK_THROW(device.open(), ChimeraTK::runtime_error);
+  }
+
+  // the device recovers once the accessor for the server which is down is gone
+  BOOST_TEST(backend->_addressCache.getLocationAddresses().size() == 1);
+  device.open();
+  BOOST_TEST(device.isFunctional());
+  scalar.read();
+  device.close();
+}
+
+/**********************************************************************************************************************/
+
+BOOST_AUTO_TEST_CASE(testRpcTimeout) {
+  BOOST_CHECK_THROW(ChimeraTK::Device("(doocs:doocs://localhost:" + DoocsLauncher::rpc_no + "/F/D?rpcTimeoutMs=abc)"),
+      ChimeraTK::logic_error);
+
+  ChimeraTK::Device device;
+  device.open("(doocs:doocs://localhost:" + DoocsLauncher::rpc_no + "/F/D?rpcTimeoutMs=5000)");
+  auto backend = boost::dynamic_pointer_cast<DoocsBackend>(device.getBackend());
+  BOOST_REQUIRE(backend);
+
+  // transfers within the timeout work as usual
+  auto scalar = device.getScalarRegisterAccessor<int32_t>("MYDUMMY/SOME_INT");
+  DoocsServerTestHelper::doocsSet("//MYDUMMY/SOME_INT", 11);
+  scalar.read();
+  BOOST_TEST(int32_t(scalar) == 11);
+  scalar = 12;
+  scalar.write();
+  BOOST_TEST(DoocsServerTestHelper::doocsGet<int>("//MYDUMMY/SOME_INT") == 12);
+
+  // timeout per accessor
+  auto array = device.getOneDRegisterAccessor<int32_t>("MYDUMMY/SOME_INT_ARRAY");
+  auto arrayImpl = boost::dynamic_pointer_cast<DoocsBackendRegisterAccessorBase>(array.getHighLevelImplElement());
+  BOOST_REQUIRE(arrayImpl);
+  BOOST_TEST(arrayImpl->getRpcTimeout().count() == 5000);
+  arrayImpl->setRpcTimeout(std::chrono::milliseconds(2000));
+  BOOST_TEST(arrayImpl->getRpcTimeout().count() == 2000);
+  array.read();
+
+  // no calls are started after the deadline has passed
+  TransferGroup group;
+  group.addAccessor(scalar);
+  group.addAccessor(array);
+  auto timeoutsBefore = backend->_statistics.get("rpc_timeout_count")[0];
+  {
+    DoocsBackendRpcDeadline deadline(std::chrono::steady_clock::now() - std::chrono::seconds(1));
+    auto start = std::chrono::steady_clock::now();
+    BOOST_CHECK_THROW(group.read(), ChimeraTK::runtime_error);
+    BOOST_TEST(std::chrono::steady_clock::now() - start < std::chrono::seconds(1));
+  }
+  BOOST_TEST(backend->_statistics.get("rpc_timeout_count")[0] > timeoutsBefore);
+
+  // recovery works normally once the deadline is gone
+  device.open();
+  group.read();
+  BOOST_TEST(int32_t(scalar) == 12);
+
+  // a server which does not answer (the location is locked, so the server cannot process the call)
+  auto location = dynamic_cast<eq_dummy*>(find_device("MYDUMMY"));
+  BOOST_REQUIRE(location);
+  arrayImpl->setRpcTimeout(std::chrono::milliseconds(500));
+  timeoutsBefore = backend->_statistics.get("rpc_timeout_count")[0];
+  location->lock();
+  {
+    auto start = std::chrono::steady_clock::now();
+    BOOST_CHECK_THROW(array.read(), ChimeraTK::runtime_error);
+    auto elapsed = std::chrono::steady_clock::now() - start;
+    BOOST_TEST(elapsed >= std::chrono::milliseconds(500));
+    BOOST_TEST(elapsed < std::chrono::seconds(3));
+
+    // further calls to the same location fail immediately while the abandoned call has not returned
+    auto address = "doocs://localhost:" + DoocsLauncher::rpc_no + "/F/D/MYDUMMY/SOME_INT";
+    DoocsBackendTimedRpc eq(address);
+    doocs::EqAdr ea;
+    ea.adr(address);
+    doocs::EqData src, dst;
+    start = std::chrono::steady_clock::now();
+    BOOST_TEST(eq.get(&ea, &src, &dst, std::chrono::milliseconds(5000)) == doocs::TransactionResult::transport_error);
+    BOOST_TEST(eq.hasTimedOut());
+    BOOST_TEST(std::chrono::steady_clock::now() - start < std::chrono::milliseconds(500));
+  }
+  location->unlock();
+  BOOST_TEST(backend->_statistics.get("rpc_timeout_count")[0] > timeoutsBefore);
+
+  // the abandoned call returns once the server answers again, then the device recovers
+  for(size_t i = 0;; ++i) {
+    try {
+      device.open();
+      break;
+    }
+    catch(ChimeraTK::runtime_error&) {
+      BOOST_REQUIRE(i < 50);
+      usleep(100000);
+    }
+  }
+  array.read();
+  scalar.read();
+  BOOST_TEST(int32_t(scalar) == 12);
+  device.close();
+}
+
+/**********************************************************************************************************************/
+
+BOOST_AUTO_TEST_CASE(testPollPeriod) {
+  // without pollPeriod, wait_for_new_data is only supported for properties with ZeroMQ
+  {
+    ChimeraTK::Device device;
+    device.open(DoocsLauncher::DoocsServer1);
+    BOOST_CHECK_THROW(
+        device.getScalarRegisterAccessor<int32_t>("MYDUMMY/SOME_INT", 0, {AccessMode::wait_for_new_data}),
+        ChimeraTK::logic_error);
+  }
+
+  auto base = "(doocs:doocs://localhost:" + DoocsLauncher::rpc_no + "/F/D?pollPeriod=100";
+  BOOST_CHECK_THROW(ChimeraTK::Device(base + "&pollThreads=0)"), ChimeraTK::logic_error);
+  BOOST_CHECK_THROW(ChimeraTK::Device(base + "&pollThreads=-1)"), ChimeraTK::logic_error);
+
+  // all properties are of the same location, so a single thread polls them anyway
+  ChimeraTK::Device device;
+  device.open(base + "&pollThreads=1)");
+  DoocsServerTestHelper::doocsSet("//MYDUMMY/SOME_INT", 21);
+
+  auto acc1 = device.getScalarRegisterAccessor<int32_t>("MYDUMMY/SOME_INT", 0, {AccessMode::wait_for_new_data});
+  auto acc2 = device.getScalarRegisterAccessor<int32_t>("MYDUMMY/SOME_INT", 0, {AccessMode::wait_for_new_data});
+  auto array =
+      device.getOneDRegisterAccessor<int32_t>("MYDUMMY/SOME_INT_ARRAY", 0, 0, {AccessMode::wait_for_new_data});
+
+  // nothing is polled before activateAsyncRead()
+  usleep(300000);
+  BOOST_TEST(!acc1.readNonBlocking());
+
+  // initial values
+  device.activateAsyncRead();
+  acc1.read();
+  acc2.read();
+  array.read();
+  BOOST_TEST(int32_t(acc1) == 21);
+  BOOST_TEST(int32_t(acc2) == 21);
+
+  // changes arrive with the next period
+  DoocsServerTestHelper::doocsSet("//MYDUMMY/SOME_INT", 22);
+  for(size_t i = 0; i < 100 && int32_t(acc1) != 22; ++i) acc1.read();
+  for(size_t i = 0; i < 100 && int32_t(acc2) != 22; ++i) acc2.read();
+  BOOST_TEST(int32_t(acc1) == 22);
+  BOOST_TEST(int32_t(acc2) == 22);
+
+  // writing is still done through RPC
+  acc1 = 23;
+  acc1.write();
+  BOOST_TEST(DoocsServerTestHelper::doocsGet<int>("//MYDUMMY/SOME_INT") == 23);
+
+  device.close();
+}
+
+/**********************************************************************************************************************/
+
+BOOST_AUTO_TEST_CASE(testChangeFilter) {
+  // comparison of the payload
+  doocs::EqData a, b;
+  a.set(1.0);
+  b.set(1.05);
+  BOOST_TEST(!DoocsBackendChangeFilter::isEqual(a, b));
+  BOOST_TEST(DoocsBackendChangeFilter::isEqual(a, b, {0.1, 0.}));
+  BOOST_TEST(!DoocsBackendChangeFilter::isEqual(a, b, {0.01, 0.}));
+  BOOST_TEST(DoocsBackendChangeFilter::isEqual(a, b, {0.01, 0.1}));
+  b.set(1);
+  BOOST_TEST(!DoocsBackendChangeFilter::isEqual(a, b, {0.1, 0.}));
+
+  // byte arrays use the deadband like other numeric arrays
+  doocs::EqData bytesA, bytesB;
+  for(auto* bytes : {&bytesA, &bytesB}) {
+    bytes->set_type(DATA_A_BYTE);
+    bytes->length(3);
+  }
+  std::vector<int8_t> valuesA{-1, 2, -3}, valuesB{-2, 2, -3};
+  DoocsBackendTypeDispatch<int8_t>::find(DATA_A_BYTE)->write(bytesA, valuesA.data(), 0, 3);
+  DoocsBackendTypeDispatch<int8_t>::find(DATA_A_BYTE)->write(bytesB, valuesB.data(), 0, 3);
+  BOOST_TEST(!DoocsBackendChangeFilter::isEqual(bytesA, bytesB));
+  BOOST_TEST(DoocsBackendChangeFilter::isEqual(bytesA, bytesB, {1., 0.}));
+  BOOST_TEST(!DoocsBackendChangeFilter::isEqual(bytesA, bytesB, {0.5, 0.}));
+
+  ChimeraTK::Device device;
+  device.open("(doocs:doocs://localhost:" + DoocsLauncher::rpc_no + "/F/D?pollPeriod=50&statistics=1)");
+  DoocsServerTestHelper::doocsSet("//MYDUMMY/SOME_INT", 31);
+
+  auto acc = device.getScalarRegisterAccessor<int32_t>("MYDUMMY/SOME_INT", 0, {AccessMode::wait_for_new_data});
+  auto impl = boost::dynamic_pointer_cast<DoocsBackendRegisterAccessorBase>(acc.getHighLevelImplElement());
+  BOOST_REQUIRE(impl);
+  impl->enableChangeFilter();
+
+  auto accNoWait = device.getScalarRegisterAccessor<int32_t>("MYDUMMY/SOME_INT");
+  auto implNoWait = boost::dynamic_pointer_cast<DoocsBackendRegisterAccessorBase>(accNoWait.getHighLevelImplElement());
+  BOOST_REQUIRE(implNoWait);
+  BOOST_CHECK_THROW(implNoWait->enableChangeFilter(), ChimeraTK::logic_error);
+
+  // the initial value is always delivered
+  device.activateAsyncRead();
+  acc.read();
+  BOOST_TEST(int32_t(acc) == 31);
+
+  // unchanged values are dropped
+  usleep(500000);
+  BOOST_TEST(!acc.readNonBlocking());
+  BOOST_TEST(impl->getSuppressedUpdateCount() > 0);
+  auto suppressed = device.getScalarRegisterAccessor<int64_t>("/_stats/suppressed_update_count");
+  suppressed.read();
+  BOOST_TEST(int64_t(suppressed) > 0);
+
+  // a change is delivered once
+  DoocsServerTestHelper::doocsSet("//MYDUMMY/SOME_INT", 32);
+  acc.read();
+  BOOST_TEST(int32_t(acc) == 32);
+  usleep(500000);
+  BOOST_TEST(!acc.readNonBlocking());
+
+  device.close();
+}
+
+/**********************************************************************************************************************/
+
+BOOST_AUTO_TEST_CASE(testTypeDispatch) {
+  // numeric types have kernels, others not
+  BOOST_TEST(DoocsBackendTypeDispatch<int32_t>::find(DATA_A_FLOAT) != nullptr);
+  BOOST_TEST(DoocsBackendTypeDispatch<int32_t>::find(DATA_USHORT) != nullptr);
+  BOOST_TEST(DoocsBackendTypeDispatch<int32_t>::find(DATA_STRING) == nullptr);
+  BOOST_TEST(DoocsBackendTypeDispatch<int32_t>::find(DATA_IFFF) == nullptr);
+  BOOST_TEST(DoocsBackendTypeDispatch<int32_t>::find(DATA_A_BYTE) != nullptr);
+  BOOST_TEST(DoocsBackendTypeDispatch<int32_t>::find(-1) == nullptr);
+
+  // read and write a slice through the kernels, with and without type conversion
+  doocs::EqData data;
+  data.set_type(DATA_A_DOUBLE);
+  data.length(5);
+  for(int i = 0; i < 5; ++i) data.set(double(i) + 0.25, i);
+
+  std::vector<double> doubles(3);
+  DoocsBackendTypeDispatch<double>::find(data.type())->read(data, doubles.data(), 1, 3);
+  BOOST_TEST(doubles == std::vector<double>({1.25, 2.25, 3.25}), boost::test_tools::per_element());
+
+  std::vector<int32_t> ints(3);
+  DoocsBackendTypeDispatch<int32_t>::find(data.type())->read(data, ints.data(), 2, 3);
+  BOOST_TEST(ints == std::vector<int32_t>({2, 3, 4}), boost::test_tools::per_element());
+
+  std::vector<int32_t> source{7, 8};
+  DoocsBackendTypeDispatch<int32_t>::find(data.type())->write(data, source.data(), 3, 2);
+  BOOST_TEST(data.get_double(2) == 2.25);
+  BOOST_TEST(data.get_double(3) == 7.);
+  BOOST_TEST(data.get_double(4) == 8.);
+
+  // byte arrays: raw copy for int8, conversion with clamping for others (including uint8)
+  doocs::EqData bytes;
+  bytes.set_type(DATA_A_BYTE);
+  bytes.length(3);
+  std::vector<int8_t> signedBytes{-1, 2, -3};
+  DoocsBackendTypeDispatch<int8_t>::find(bytes.type())->write(bytes, signedBytes.data(), 0, 3);
+  std::vector<int8_t> rawBytes(3);
+  DoocsBackendTypeDispatch<int8_t>::find(bytes.type())->read(bytes, rawBytes.data(), 0, 3);
+  BOOST_TEST(rawBytes == signedBytes, boost::test_tools::per_element());
+  std::vector<uint8_t> unsignedBytes(3);
+  DoocsBackendTypeDispatch<uint8_t>::find(bytes.type())->read(bytes, unsignedBytes.data(), 0, 3);
+  BOOST_TEST(unsignedBytes == std::vector<uint8_t>({0, 2, 0}), boost::test_tools::per_element());
+  std::vector<float> floats(3);
+  DoocsBackendTypeDispatch<float>::find(bytes.type())->read(bytes, floats.data(), 0, 3);
+  BOOST_TEST(floats == std::vector<float>({-1.f, 2.f, -3.f}), boost::test_tools::per_element());
+}
+
+/**********************************************************************************************************************/
@@ -1,6 +1,11 @@
 
+#include "DoocsBackend.h"
+#include "DoocsBackendEventBundle.h"
+#include "DoocsBackendRegisterAccessor.h"
+#include "DoocsBackendSpscRing.h"
 #include "eq_dummy.h"
 
+#include <fstream>
 #include <random>
 #include <thread>
 
@@ -140,3 +145,386 @@ BOOST_AUTO_TEST_CASE(testZeroMQ) {
 }
 
 /**********************************************************************************************************************/
+
+/**********************************************************************************************************************/
+
+BOOST_AUTO_TEST_CASE(testLatencyTracing) {
+  std::string traceFile = "testZeroMQ_trace.json";
+  auto cdd = DoocsLauncher::DoocsServer1.substr(0, DoocsLauncher::DoocsServer1.size() - 1) +
+      "?latencyTracing=1&traceFile=" + traceFile + ")";
+
+  ChimeraTK::Device device;
+  device.open(cdd);
+  device.activateAsyncRead();
+  auto backend = boost::dynamic_pointer_cast<DoocsBackend>(device.getBackend());
+  BOOST_REQUIRE(backend);
+  BOOST_TEST(backend->_latencyTracer.isEnabled());
+
+  auto acc = device.getScalarRegisterAccessor<int32_t>("MYDUMMY/SOME_ZMQINT", 0, {AccessMode::wait_for_new_data});
+
+  // wait until ZeroMQ updates arrive, then collect a couple of traced updates
+  size_t ic = 0;
+  while(!acc.readNonBlocking() || ++ic < 10) {
+    DoocsServerTestHelper::runUpdate();
+  }
+
+  auto reports = backend->_latencyTracer.getReports();
+  BOOST_REQUIRE_EQUAL(reports.size(), 1);
+  BOOST_TEST(reports[0].path.find("MYDUMMY/SOME_ZMQINT") != std::string::npos);
+  BOOST_TEST(reports[0].count > 0);
+  BOOST_TEST(reports[0].enqueueToRead.p50 <= reports[0].enqueueToRead.max);
+  BOOST_TEST(reports[0].callbackToEnqueue.max >= 0);
+
+  // the trace file is written on close
+  device.close();
+  std::ifstream f(traceFile);
+  BOOST_REQUIRE(f.good());
+  std::string content((std::istreambuf_iterator<char>(f)), std::istreambuf_iterator<char>());
+  BOOST_TEST(content.find("\"traceEvents\"") != std::string::npos);
+  BOOST_TEST(content.find("enqueue to read") != std::string::npos);
+  f.close();
+  std::remove(traceFile.c_str());
+}
+
+/**********************************************************************************************************************/
+
+BOOST_AUTO_TEST_CASE(testNotificationBuffersReused) {
+  auto cdd = DoocsLauncher::DoocsServer1.substr(0, DoocsLauncher::DoocsServer1.size() - 1) + "?statistics=1)";
+
+  ChimeraTK::Device device;
+  device.open(cdd);
+  device.activateAsyncRead();
+  auto bufferCount = device.getScalarRegisterAccessor<int64_t>("/_stats/zmq_buffer_count");
+
+  // the accessors of the same property share the buffers
+  auto acc = device.getScalarRegisterAccessor<int32_t>("MYDUMMY/SOME_ZMQINT", 0, {AccessMode::wait_for_new_data});
+  auto acc2 = device.getScalarRegisterAccessor<int32_t>("MYDUMMY/SOME_ZMQINT", 0, {AccessMode::wait_for_new_data});
+  auto impl = boost::dynamic_pointer_cast<DoocsBackendRegisterAccessorBase>(acc.getHighLevelImplElement());
+  auto impl2 = boost::dynamic_pointer_cast<DoocsBackendRegisterAccessorBase>(acc2.getHighLevelImplElement());
+  BOOST_REQUIRE(impl && impl2);
+  BOOST_TEST(impl->_eqDataPool == impl2->_eqDataPool);
+
+  // wait until ZeroMQ updates arrive
+  size_t ic = 0;
+  while(!acc.readNonBlocking() || ++ic < 10) {
+    DoocsServerTestHelper::runUpdate();
+  }
+
+  // The buffers are allocated on demand. Many updates, also overflowing the notification queues, allocate at most one
+  // buffer per queue slot of each accessor plus two.
+  auto flood = [&] {
+    for(size_t i = 0; i < 100; ++i) {
+      DoocsServerTestHelper::runUpdate();
+      if(i % 3 == 0) acc.readLatest();
+    }
+    usleep(100000);
+    acc2.readLatest();
+  };
+  flood();
+  bufferCount.read();
+  auto allocated = int64_t(bufferCount);
+  BOOST_TEST(allocated > 0);
+  BOOST_TEST(allocated <= 2 * 4 + 2);
+  BOOST_TEST(impl->_eqDataPool->getNumberOfBuffers() <= 2 * 4 + 2);
+
+  // the buffers are reused afterwards
+  flood();
+  acc.readLatest();
+  auto value = int32_t(acc);
+  DoocsServerTestHelper::runUpdate();
+  acc.read();
+  BOOST_TEST(int32_t(acc) == value + 1);
+
+  bufferCount.read();
+  BOOST_TEST(int64_t(bufferCount) == allocated);
+
+  device.close();
+}
+
+/**********************************************************************************************************************/
+
+BOOST_AUTO_TEST_CASE(testEventBundle) {
+  ChimeraTK::Device device;
+  device.open(DoocsLauncher::DoocsServer1);
+  ChimeraTK::Device device2;
+  device2.open(DoocsLauncher::DoocsServer2);
+
+  auto acc1 = device.getScalarRegisterAccessor<int32_t>("MYDUMMY/SOME_ZMQINT", 0, {AccessMode::wait_for_new_data});
+  auto acc2 = device2.getScalarRegisterAccessor<int32_t>("SOME_ZMQINT", 0, {AccessMode::wait_for_new_data});
+  auto bundle = DoocsBackendEventBundle::create(4);
+  bundle->add(acc1);
+  bundle->add(acc2);
+
+  // only ZeroMQ accessors can be added, and only to one bundle
+  auto accPoll = device.getScalarRegisterAccessor<int32_t>("MYDUMMY/SOME_ZMQINT");
+  BOOST_CHECK_THROW(bundle->add(accPoll), ChimeraTK::logic_error);
+  BOOST_CHECK_THROW(DoocsBackendEventBundle::create()->add(acc1), ChimeraTK::logic_error);
+
+  device.activateAsyncRead();
+  device2.activateAsyncRead();
+
+  // wait until ZeroMQ updates arrive
+  size_t ic = 0;
+  while(!acc1.readNonBlocking() || ++ic < 10) {
+    DoocsServerTestHelper::runUpdate();
+  }
+  usleep(100000);
+  acc1.readLatest();
+  acc2.readLatest();
+
+  // each read of the bundle delivers values with the same eventId
+  for(size_t i = 0; i < 5; ++i) {
+    DoocsServerTestHelper::runUpdate();
+    bundle->read();
+    BOOST_TEST(int32_t(acc1) == int32_t(acc2));
+    BOOST_TEST(acc1.getVersionNumber() == acc2.getVersionNumber());
+  }
+  BOOST_TEST(bundle->getIncompleteCount() == 0);
+
+  // after re-opening, the eventIds may start again lower (e.g. after a restart of the server). The counter starts at
+  // 1234, so the new eventIds have not been seen before.
+  device.close();
+  device2.close();
+  auto eqfct = dynamic_cast<eq_dummy*>(find_device("MYDUMMY"));
+  BOOST_REQUIRE(eqfct);
+  auto id = eqfct->counter;
+  eqfct->counter = 100;
+  device.open();
+  device2.open();
+  device.activateAsyncRead();
+  device2.activateAsyncRead();
+  acc1.read();
+  acc2.read();
+  usleep(100000);
+  acc1.readLatest();
+  acc2.readLatest();
+  for(size_t i = 0; i < 5; ++i) {
+    DoocsServerTestHelper::runUpdate();
+    CHECK_TIMEOUT(acc1.readNonBlocking(), 10000);
+    BOOST_TEST(acc2.readNonBlocking());
+    BOOST_TEST(int32_t(acc1) == int32_t(acc2));
+    BOOST_TEST(acc1.getVersionNumber() == acc2.getVersionNumber());
+  }
+
+  device.close();
+  device2.close();
+  eqfct->counter = id;
+}
+
+/**********************************************************************************************************************/
+
+BOOST_AUTO_TEST_CASE(testDecimation) {
+  ChimeraTK::Device device;
+  device.open(DoocsLauncher::DoocsServer1);
+  device.activateAsyncRead();
+
+  auto acc = device.getScalarRegisterAccessor<int32_t>("MYDUMMY/SOME_ZMQINT", 0, {AccessMode::wait_for_new_data});
+  auto impl = boost::dynamic_pointer_cast<DoocsBackendRegisterAccessorBase>(acc.getHighLevelImplElement());
+  BOOST_REQUIRE(impl);
+
+  // wait until ZeroMQ updates arrive
+  size_t ic = 0;
+  while(!acc.readNonBlocking() || ++ic < 10) {
+    DoocsServerTestHelper::runUpdate();
+  }
+  usleep(100000);
+  acc.readLatest();
+
+  // only every 3rd update is delivered (the value is incremented with each update)
+  impl->setDecimation(3);
+  for(size_t i = 0; i < 3; ++i) DoocsServerTestHelper::runUpdate();
+  acc.read();
+  auto value = int32_t(acc);
+  for(size_t i = 0; i < 3; ++i) DoocsServerTestHelper::runUpdate();
+  acc.read();
+  BOOST_TEST(int32_t(acc) == value + 3);
+  usleep(100000);
+  BOOST_TEST(!acc.readNonBlocking());
+  BOOST_TEST(impl->getSuppressedUpdateCount() >= 2);
+
+  // deadband larger than the increment: changes are only delivered once they exceed the deadband
+  impl->setDecimation(1);
+  impl->setDeadband(2.5);
+  for(size_t i = 0; i < 3; ++i) DoocsServerTestHelper::runUpdate();
+  acc.read();
+  BOOST_TEST(int32_t(acc) == value + 6);
+  usleep(100000);
+  BOOST_TEST(!acc.readNonBlocking());
+
+  device.close();
+}
+
+/**********************************************************************************************************************/
+
+BOOST_AUTO_TEST_CASE(testZmqThreadSettings) {
+  // parsing of the CDD parameters
+  auto settings = DoocsBackendThreadSettings::parse("2,3,8-10", "rr", "10");
+  BOOST_TEST((settings.cpus == std::vector<int>{2, 3, 8, 9, 10}));
+  BOOST_TEST(*settings.policy == SCHED_RR);
+  BOOST_TEST(settings.priority == 10);
+  BOOST_TEST(*DoocsBackendThreadSettings::parse("", "", "10").policy == SCHED_FIFO);
+  BOOST_TEST(DoocsBackendThreadSettings::parse("", "", "").isEmpty());
+  BOOST_CHECK_THROW(DoocsBackendThreadSettings::parse("2-a", "", ""), ChimeraTK::logic_error);
+  BOOST_CHECK_THROW(DoocsBackendThreadSettings::parse("3-2", "", ""), ChimeraTK::logic_error);
+  BOOST_CHECK_THROW(DoocsBackendThreadSettings::parse("", "realtime", ""), ChimeraTK::logic_error);
+  BOOST_CHECK_THROW(DoocsBackendThreadSettings::parse("", "fifo", "1000"), ChimeraTK::logic_error);
+  auto cdd = [](const std::string& parameters) {
+    auto& base = DoocsLauncher::DoocsServer1;
+    return base.substr(0, base.size() - 1) + "?" + parameters + ")";
+  };
+  BOOST_CHECK_THROW(ChimeraTK::Device(cdd("zmqCpus=x")), ChimeraTK::logic_error);
+
+  // settings which do not require privileges: updates are still received
+  ChimeraTK::Device device(cdd("zmqCpus=0&zmqSchedPolicy=other"));
+  device.open();
+  device.activateAsyncRead();
+  auto acc = device.getScalarRegisterAccessor<int32_t>("MYDUMMY/SOME_ZMQINT", 0, {AccessMode::wait_for_new_data});
+  acc.read();
+  size_t ic = 0;
+  while(!acc.readNonBlocking() || ++ic < 3) {
+    DoocsServerTestHelper::runUpdate();
+  }
+  device.close();
+}
+
+/**********************************************************************************************************************/
+
+BOOST_AUTO_TEST_CASE(testDecodingWorkers) {
+  auto cdd = [](const std::string& parameters) {
+    auto& base = DoocsLauncher::DoocsServer1;
+    return base.substr(0, base.size() - 1) + "?" + parameters + ")";
+  };
+  BOOST_CHECK_THROW(ChimeraTK::Device(cdd("zmqWorkers=-1")), ChimeraTK::logic_error);
+
+  ChimeraTK::Device device(cdd("zmqWorkers=2&statistics=1"));
+  device.open();
+  device.activateAsyncRead();
+  auto acc = device.getScalarRegisterAccessor<int32_t>("MYDUMMY/SOME_ZMQINT", 0, {AccessMode::wait_for_new_data});
+  auto acc2 = device.getScalarRegisterAccessor<int32_t>("MYDUMMY/SOME_ZMQINT", 0, {AccessMode::wait_for_new_data});
+
+  // wait until ZeroMQ updates arrive through the workers
+  acc.read();
+  acc2.read();
+  size_t ic = 0;
+  while(!acc.readNonBlocking() || ++ic < 10) {
+    DoocsServerTestHelper::runUpdate();
+  }
+  usleep(100000);
+  acc.readLatest();
+  acc2.readLatest();
+  BOOST_TEST(int32_t(acc) == int32_t(acc2));
+
+  // updates are delivered in order to all accessors (the value is incremented with each update)
+  auto value = int32_t(acc);
+  for(int32_t i = 1; i <= 5; ++i) {
+    DoocsServerTestHelper::runUpdate();
+    acc.read();
+    acc2.read();
+    BOOST_TEST(int32_t(acc) == value + i);
+    BOOST_TEST(int32_t(acc2) == value + i);
+  }
+
+  auto dropped = device.getScalarRegisterAccessor<int64_t>("/_stats/zmq_handoff_dropped_count");
+  dropped.read();
+  BOOST_TEST(int64_t(dropped) == 0);
+
+  device.close();
+}
+
+/**********************************************************************************************************************/
+
+BOOST_AUTO_TEST_CASE(testHandOffRingKeepsLatest) {
+  // flood the ring without a consumer: the values which fit are kept in order, the latest one is kept in the overflow
+  // slot and all values in between are dropped
+  DoocsBackendSpscRing<int, 8> ring;
+  size_t dropped = 0;
+  for(int i = 0; i < 100; ++i) {
+    dropped += ring.pushLatest(int(i));
+  }
+  BOOST_TEST(dropped == 100 - 8 - 1);
+  BOOST_TEST(ring.hasOverflow());
+
+  std::vector<int> received;
+  int value;
+  while(ring.pop(value)) {
+    received.push_back(value);
+  }
+  BOOST_TEST(received == std::vector<int>({0, 1, 2, 3, 4, 5, 6, 7, 99}));
+  BOOST_TEST(!ring.hasOverflow());
+
+  // the ring is used again once the overflow slot has been taken
+  BOOST_TEST(ring.pushLatest(100) == 0);
+  BOOST_TEST(!ring.hasOverflow());
+  BOOST_TEST(ring.pop(value));
+  BOOST_TEST(value == 100);
+  BOOST_TEST(!ring.pop(value));
+
+  // flood the ring of a real subscription: the final value must arrive even if updates were dropped
+  auto& base = DoocsLauncher::DoocsServer1;
+  ChimeraTK::Device device(base.substr(0, base.size() - 1) + "?zmqWorkers=1)");
+  device.open();
+  device.activateAsyncRead();
+  auto acc = device.getScalarRegisterAccessor<int32_t>("MYDUMMY/SOME_ZMQINT", 0, {AccessMode::wait_for_new_data});
+  acc.read();
+  size_t ic = 0;
+  while(!acc.readNonBlocking() || ++ic < 10) {
+    DoocsServerTestHelper::runUpdate();
+  }
+  usleep(100000);
+  acc.readLatest();
+  auto start = int32_t(acc);
+  // much more updates than the hand-off ring can hold
+  const int32_t nUpdates = 1000;
+  for(int32_t i = 0; i < nUpdates; ++i) {
+    DoocsServerTestHelper::runUpdate();
+  }
+  auto expected = start + nUpdates;
+  CHECK_TIMEOUT((acc.readLatest(), int32_t(acc) == expected), 10000);
+
+  device.close();
+}
+
+/**********************************************************************************************************************/
+
+BOOST_AUTO_TEST_CASE(testConvertOnReceive) {
+  auto& base = DoocsLauncher::DoocsServer1;
+  ChimeraTK::Device device(base.substr(0, base.size() - 1) + "?convertOnReceive=1)");
+  device.open();
+  device.activateAsyncRead();
+
+  // two accessors sharing the conversion, and one with a different UserType
+  auto acc = device.getScalarRegisterAccessor<int32_t>("MYDUMMY/SOME_ZMQINT", 0, {AccessMode::wait_for_new_data});
+  auto acc2 = device.getScalarRegisterAccessor<int32_t>("MYDUMMY/SOME_ZMQINT", 0, {AccessMode::wait_for_new_data});
+  auto accDouble = device.getScalarRegisterAccessor<double>("MYDUMMY/SOME_ZMQINT", 0, {AccessMode::wait_for_new_data});
+  auto impl = boost::dynamic_pointer_cast<DoocsBackendRegisterAccessorBase>(acc.getHighLevelImplElement());
+  BOOST_REQUIRE(impl);
+  BOOST_TEST(impl->convertOnReceive);
+
+  // wait until ZeroMQ updates arrive
+  acc.read();
+  size_t ic = 0;
+  while(!acc.readNonBlocking() || ++ic < 10) {
+    DoocsServerTestHelper::runUpdate();
+  }
+  usleep(100000);
+  acc.readLatest();
+  acc2.readLatest();
+  accDouble.readLatest();
+
+  // values are identical to the values converted by read()
+  auto value = int32_t(acc);
+  for(int32_t i = 1; i <= 5; ++i) {
+    DoocsServerTestHelper::runUpdate();
+    acc.read();
+    acc2.read();
+    accDouble.read();
+    BOOST_TEST(int32_t(acc) == value + i);
+    BOOST_TEST(int32_t(acc2) == value + i);
+    BOOST_TEST(double(accDouble) == value + i);
+    BOOST_TEST(acc.getVersionNumber() == acc2.getVersionNumber());
+  }
+
+  device.close();
+}
+
+/**********************************************************************************************************************/